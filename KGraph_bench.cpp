@@ -0,0 +1,330 @@
+//===-- KGraph_bench.cpp -- performance reports for graph algorithms ------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Not part of tests: make -f Makefile.debug bench OPT=-O2
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGraph.hpp"
+#include "KGAlg.hpp"
+#include "KGDynamic.hpp"
+#include "KGOrder.hpp"
+#include "KGPacked.hpp"
+#include "KGSplit.hpp"
+
+#include <chrono>
+#include <random>
+
+using KGR::DynamicMatching;
+using KGR::Graph;
+using KGR::GraphBuilder;
+using KGR::PackedGraph;
+using KGR::SplitGraph;
+using KGR::VCProblem;
+using KGR::VCWorkspace;
+using KGR::VertexOrder;
+using KGR::colorload;
+using KGR::noload;
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+  auto now = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(now - start).count();
+}
+
+// grid with randomly shuffled labels: locality is destroyed on purpose
+static VCProblem shuffled_grid(int side, unsigned seed) {
+  VCProblem p;
+  vector<int> label(side * side);
+  for (size_t i = 0; i != label.size(); ++i)
+    label[i] = i;
+  std::shuffle(label.begin(), label.end(), std::mt19937(seed));
+
+  p.add_isolated(side * side);
+  for (int r = 0; r != side; ++r)
+    for (int c = 0; c != side; ++c) {
+      if (c + 1 != side)
+        p.add_link(label[r * side + c], label[r * side + c + 1]);
+      if (r + 1 != side)
+        p.add_link(label[r * side + c], label[(r + 1) * side + c]);
+    }
+  return p;
+}
+
+// effect of relabeling on traversal and matching
+int bench_order(void) {
+  VCProblem p = shuffled_grid(600, 42);
+  VertexOrder orders[] = {VertexOrder::natural, VertexOrder::degree,
+                          VertexOrder::bfs, VertexOrder::rcm,
+                          VertexOrder::gorder};
+  VCWorkspace ws;
+
+  cout << "order: grid 600x600, shuffled labels" << endl;
+  cout << std::setw(10) << std::left << "order" << std::setw(12) << "reorder,s"
+       << std::setw(12) << "bandwidth" << std::setw(10) << "loggap"
+       << std::setw(12) << "color,s" << std::setw(12) << "matching,s"
+       << endl;
+
+  for (auto how : orders) {
+    auto start = std::chrono::steady_clock::now();
+    auto adj = make_adjacency(p);
+    auto order = vertex_order(adj, how);
+    Graph<colorload, noload> g(p.n, p.edges, order);
+    double treorder = seconds_since(start);
+
+    auto stats = order_stats(g);
+
+    start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep != 5; ++rep)
+      color_bipartite(g);
+    double tcolor = seconds_since(start);
+
+    VCProblem q = relabel(p, order);
+    ws.load(q);
+    start = std::chrono::steady_clock::now();
+    ws.lp_kernel();
+    double tmatch = seconds_since(start);
+
+    cout << std::setw(10) << order_name(how) << std::setw(12) << treorder
+         << std::setw(12) << stats.bandwidth << std::setw(10)
+         << stats.avg_loggap << std::setw(12) << tcolor << std::setw(12)
+         << tmatch << endl;
+  }
+  return 0;
+}
+
+// per-update repair against full recomputation
+int bench_dynamic(const VCProblem &p, const char *name) {
+  const int nupd = 2000;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, p.n - 1);
+  GraphBuilder<colorload, noload> g;
+  g.add_isolated(p.n);
+  for (auto e : p.edges)
+    g.add_link(e.first, e.second);
+
+  auto start = std::chrono::steady_clock::now();
+  DynamicMatching<colorload, noload> dyn(g);
+  double tinit = seconds_since(start);
+
+  vector<pair<int, int>> added;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i != nupd; ++i) {
+    int u = pick(rng), v = pick(rng);
+    if (u == v)
+      continue;
+    dyn.insert(u, v);
+    added.emplace_back(u, v);
+  }
+  for (auto e : added)
+    dyn.remove(e.first, e.second);
+  double tupd = seconds_since(start) / (2 * added.size());
+
+  VCWorkspace ws;
+  start = std::chrono::steady_clock::now();
+  ws.load(p);
+  int full = ws.lp_kernel();
+  double tfull = seconds_since(start);
+  assert(full == dyn.matching());
+
+  cout << "dynamic: " << name << ", n=" << p.n << " m=" << p.edges.size()
+       << endl;
+  cout << "  initial matching,s " << tinit << endl;
+  cout << "  per update,us      " << tupd * 1e6 << endl;
+  cout << "  full recompute,s   " << tfull << endl;
+  return 0;
+}
+
+// adjacency bytes and traversal time, plain CSR against gap-encoded rows
+int bench_packed(const VCProblem &p, const char *name) {
+  auto order = vertex_order(make_adjacency(p), VertexOrder::rcm);
+  VCProblem q = relabel(p, order);
+  Graph<colorload, noload> g(q.n, q.edges);
+  PackedGraph<colorload, noload> pg(q.n, q.edges);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int rep = 0; rep != 5; ++rep)
+    color_bipartite(g);
+  double tplain = seconds_since(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int rep = 0; rep != 5; ++rep)
+    color_bipartite(pg);
+  double tpacked = seconds_since(start);
+
+  size_t plain = (g.nvertices() + 1 + g.narcs()) * sizeof(uint32_t);
+  cout << "packed: " << name << " (rcm order), n=" << q.n
+       << " m=" << q.edges.size() << endl;
+  cout << "  csr bytes/arc      " << (double)plain / g.narcs() << endl;
+  cout << "  packed bytes/arc   " << (double)pg.adjacency_bytes() / pg.narcs()
+       << endl;
+  cout << "  csr color x5,s     " << tplain << endl;
+  cout << "  packed color x5,s  " << tpacked << endl;
+  return 0;
+}
+
+// construction rate: builder one link at a time, serial edge-list freeze,
+// bulk with sorting and merging
+int bench_bulk(int n, size_t m) {
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int> pick(0, n - 1);
+  vector<pair<int, int>> edges;
+  edges.reserve(m);
+  while (edges.size() != m) {
+    int u = pick(rng), v = pick(rng);
+    if (u != v)
+      edges.emplace_back(u, v);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    GraphBuilder<colorload, noload> g;
+    g.add_isolated(n);
+    for (auto e : edges)
+      g.add_link(e.first, e.second);
+  }
+  double tbuilder = seconds_since(start);
+
+  start = std::chrono::steady_clock::now();
+  { Graph<colorload, noload> g(n, edges); }
+  double tlist = seconds_since(start);
+
+  start = std::chrono::steady_clock::now();
+  { Graph<colorload, noload> g(n, edges.data(), m, 0); }
+  double tbulk = seconds_since(start);
+
+  cout << "bulk: random graph, n=" << n << " m=" << m << ", "
+       << KGR::thread_count(0) << " threads" << endl;
+  cout << "  add_link loop, Medges/s  " << m / tbuilder * 1e-6 << endl;
+  cout << "  edge-list Graph, Medges/s " << m / tlist * 1e-6 << endl;
+  cout << "  bulk Graph, Medges/s      " << m / tbulk * 1e-6 << endl;
+  return 0;
+}
+
+// edge lookups from hubs, like get_sibling calls of matching code
+int bench_index(int hub_degree) {
+  const int nleft = 200000, nright = 200000, nhubs = 20, nqueries = 200000;
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> pick(0, nright - 1);
+  GraphBuilder<colorload, colorload> g;
+  g.add_isolated(nleft + nright);
+  g.set_hub_degree(hub_degree);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int u = 0; u != nleft; ++u) {
+    g.add_link(u, nleft + u % nhubs);
+    g.add_link(u, nleft + pick(rng));
+  }
+  double tbuild = seconds_since(start);
+
+  std::uniform_int_distribution<int> left(0, nleft - 1);
+  int found = 0;
+  start = std::chrono::steady_clock::now();
+  for (int q = 0; q != nqueries; ++q) {
+    int u = left(rng);
+    found += (g.get_edge(g.vertex(nleft + u % nhubs), g.vertex(u)) != nullptr);
+  }
+  double tquery = seconds_since(start);
+  assert(found == nqueries);
+
+  cout << "index: hub degree " << hub_degree << ", " << nhubs
+       << " hubs of degree " << g.degree(g.vertex(nleft)) << endl;
+  cout << "  build,s            " << tbuild << endl;
+  cout << "  hub get_edge,us    " << tquery / nqueries * 1e6 << endl;
+  return 0;
+}
+
+// vertex with payload beside color, like weights and labels of real loads
+struct fatload {
+  int color;
+  char payload[60];
+};
+
+// BFS from every unvisited vertex, distances outside of graph: topology
+// only, so loads interleaved with offsets and tips are dead weight
+template <typename G> static long bfs_all(G &g, vector<int> &dist) {
+  long sum = 0;
+  vector<int> queue;
+  dist.assign(g.nvertices(), -1);
+  for (auto s : g) {
+    if (dist[g.index(s)] != -1)
+      continue;
+    dist[g.index(s)] = 0;
+    queue.assign(1, g.index(s));
+    for (size_t i = 0; i != queue.size(); ++i) {
+      auto u = g.vertex(queue[i]);
+      for (auto ed = u->arcs; ed != g.last_edge(); ed = ed->next) {
+        int t = g.index(ed->tip);
+        if (dist[t] == -1) {
+          dist[t] = dist[queue[i]] + 1;
+          sum += dist[t];
+          queue.push_back(t);
+        }
+      }
+    }
+  }
+  return sum;
+}
+
+// interleaved loads (Graph) against loads apart from topology (SplitGraph)
+int bench_split(const VCProblem &p, const char *name) {
+  Graph<fatload, colorload> g(p.n, p.edges);
+  SplitGraph<fatload, colorload> sg(p.n, p.edges);
+  vector<int> dist;
+
+  auto start = std::chrono::steady_clock::now();
+  long sum = 0;
+  for (int rep = 0; rep != 5; ++rep)
+    sum += bfs_all(g, dist);
+  double tgraph = seconds_since(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int rep = 0; rep != 5; ++rep)
+    sum -= bfs_all(sg, dist);
+  double tsplit = seconds_since(start);
+  assert(sum == 0);
+
+  start = std::chrono::steady_clock::now();
+  for (int rep = 0; rep != 5; ++rep)
+    color_bipartite(g);
+  double cgraph = seconds_since(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int rep = 0; rep != 5; ++rep)
+    color_bipartite(sg);
+  double csplit = seconds_since(start);
+
+  cout << "split: " << name << ", n=" << p.n << " m=" << p.edges.size()
+       << ", " << sizeof(fatload) << "-byte vertex loads" << endl;
+  cout << "  graph bfs x5,s     " << tgraph << endl;
+  cout << "  split bfs x5,s     " << tsplit << endl;
+  cout << "  graph color x5,s   " << cgraph << endl;
+  cout << "  split color x5,s   " << csplit << endl;
+  return 0;
+}
+
+int main(void) {
+  bench_order();
+
+  VCProblem rnd;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, 99999);
+  rnd.add_isolated(100000);
+  for (int i = 0; i != 300000; ++i) {
+    int u = pick(rng), v = pick(rng);
+    if (u != v)
+      rnd.add_link(u, v);
+  }
+  bench_dynamic(rnd, "random graph");
+  bench_dynamic(shuffled_grid(300, 42), "grid 300x300");
+  bench_packed(shuffled_grid(600, 42), "grid 600x600");
+  bench_packed(rnd, "random graph");
+  bench_bulk(1000000, 10000000);
+  bench_index(0);
+  bench_index(64);
+  bench_split(shuffled_grid(600, 42), "grid 600x600");
+  bench_split(rnd, "random graph");
+}
@@ -7,10 +7,66 @@
 
 #include "KGraph.hpp"
 #include "KGAlg.hpp"
+#include "KGBatch.hpp"
+#include "KGCache.hpp"
+#include "KGCanon.hpp"
+#include "KGDense.hpp"
+#include "KGDynamic.hpp"
+#include "KGMapped.hpp"
+#include "KGOrder.hpp"
+#include "KGPacked.hpp"
+#include "KGPipeline.hpp"
+#include "KGSplit.hpp"
+#include "KGStatic.hpp"
+#include "KGStream.hpp"
 
 using KGR::noload;
 using KGR::colorload;
+using KGR::BitGraph;
+using KGR::DynamicMatching;
+using KGR::Graph;
 using KGR::GraphBuilder;
+using KGR::MappedGraph;
+using KGR::PackedGraph;
+using KGR::SplitGraph;
+using KGR::StreamCover;
+using KGR::VCPool;
+using KGR::VCProblem;
+using KGR::VCSolution;
+using KGR::VCWorkspace;
+using KGR::VertexOrder;
+
+// same linear congruential generator everywhere, so random tests repeat
+class Lcg {
+  unsigned seed_;
+
+public:
+  explicit Lcg(unsigned seed) : seed_(seed) {}
+  unsigned next() { return seed_ = seed_ * 1103515245u + 12345u; }
+  unsigned operator()(unsigned mod) { return (next() >> 16) % mod; }
+};
+
+// files written by tests are removed by them, only .dot pictures
+// and .mps models stay
+void remove_files(std::initializer_list<const char *> names) {
+  for (auto name : names)
+    std::remove(name);
+}
+
+// K(3, 5), even cycle and isolated vertices: bipartite, matching of 6
+void add_bipart_fixture(GraphBuilder<colorload, colorload> &GNC) {
+  GNC.add_full_bipart(3, 5);
+  GNC.add_cycle(6);
+  GNC.add_isolated(2);
+}
+
+// other representation of fixture gives same answers as builder
+template <typename G>
+void check_bipart_fixture(G &g, GraphBuilder<colorload, colorload> &GNC) {
+  assert(color_bipartite(g) && color_bipartite(GNC));
+  assert(hopcroft_karp(g) == 6 && hopcroft_karp(GNC) == 6);
+  assert(matching_to_cover(g) == 6);
+}
 
 int test_simple(void) {
   GraphBuilder<noload, noload> GN;
@@ -113,6 +169,7 @@ int vc_routine(string gname) {
   ofs << GNC << endl;
   ofs.close();
   GNC.cleanup();
+  return 0;
 }
 
 int test_vc(void) {
@@ -216,6 +273,1683 @@ int test_bst(void) {
   ofs.close();
   GNC.cleanup();
 
+  // path 0-1-2-3-4 numbered from inside: still walked from its end
+  using FG = Graph<colorload, colorload>;
+  using FVD = typename FG::VertexDescriptor;
+  auto cbf = [](FVD vd) {
+    int c = vd->load.color;
+    return (c == 0) ? 0 : (c == 2) ? 1 : -1;
+  };
+  auto cmf = [](FVD vd, int c) { vd->load.color = (c > 0) ? 2 : 0; };
+  FG FP(5, {{1, 0}, {1, 2}, {2, 3}, {3, 4}});
+  for (auto vd : FP)
+    vd->load.color = 1;
+  n = vertex_cover_trivial(FP, cbf, cmf);
+  assert(n == 2);
+
+  // many long components, split between threads
+  vector<pair<int, int>> edges;
+  int nv = 0, expected = 0;
+  for (int len = 3; len != 300; ++len) {
+    for (int i = 0; i + 1 != len; ++i)
+      edges.emplace_back(nv + i, nv + i + 1);
+    if (len % 2)
+      edges.emplace_back(nv + len - 1, nv); // odd cycle
+    expected += (len % 2) ? (len + 1) / 2 : len / 2;
+    nv += len;
+  }
+  FG FL(nv, edges);
+  for (auto vd : FL)
+    vd->load.color = 1;
+  FL.front()->load.color = 2; // marked vertices are not touched
+  n = vertex_cover_trivial(FL, cbf, cmf, 4);
+  assert(n == expected - 1);
+  for (auto vd : FL)
+    for (auto ed = vd->arcs; ed != FL.last_edge(); ed = ed->next)
+      assert(vd->load.color == 2 || ed->tip->load.color == 2);
+
+  return 0;
+}
+
+int test_formats(void) {
+  bool res;
+  GraphBuilder<colorload, colorload> GNC, GRD;
+  using VD = typename GraphBuilder<colorload, colorload>::VertexDescriptor;
+  ifstream ifs;
+  ofstream ofs;
+
+  ifs.open("petersen.inp", ifstream::in);
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+  assert(GNC.nvertices() == 10);
+  assert(count_edges(GNC) == 15);
+
+  ostringstream pace;
+  out_pace_to_stream(pace, GNC);
+  istringstream pacein("c petersen\n" + pace.str());
+  read_pace_from_stream(pacein, GRD);
+  assert(GRD.nvertices() == 10);
+  assert(count_edges(GRD) == 15);
+  for (auto vd : GRD)
+    assert(GRD.degree(vd) == 3);
+  GRD.cleanup();
+
+  ostringstream dimacs;
+  out_dimacs_to_stream(dimacs, GNC);
+  // reversed duplicate shall be dropped
+  istringstream dimacsin(dimacs.str() + "e 2 1\r\n");
+  read_dimacs_from_stream(dimacsin, GRD);
+  assert(GRD.nvertices() == 10);
+  assert(count_edges(GRD) == 15);
+  GRD.cleanup();
+
+  ostringstream metis;
+  out_metis_to_stream(metis, GNC);
+  istringstream metisin(metis.str());
+  read_metis_from_stream(metisin, GRD);
+  assert(GRD.nvertices() == 10);
+  assert(count_edges(GRD) == 15);
+  GRD.cleanup();
+
+  // weighted METIS with isolated vertex
+  istringstream wmetis("% weighted\n4 2 11\n5 2 7\n5 1 7 3 1\n5 2 1\n5\n");
+  read_metis_from_stream(wmetis, GRD);
+  assert(GRD.nvertices() == 4);
+  assert(count_edges(GRD) == 2);
+  assert(GRD.degree(GRD.back()) == 0);
+  GRD.cleanup();
+
+  // buffered writers keep exact layout of dot and mps
+  GRD.add_path(2);
+  ostringstream dot, mps;
+  dot << GRD;
+  assert(dot.str() == "graph G{\nv0[color=\"black\"];\nv1[color=\"black\"];\n"
+                      "v0 -- v1[color=\"black\"]\n}\n");
+  out_mps_to_stream(mps, GRD);
+  assert(mps.str().find("COLUMNS\n    V0        COST                1\n"
+                        "    V0        V0V1                1\n") !=
+         string::npos);
+  assert(mps.str().find("BOUNDS\n LO BND1      V0                  0\n") !=
+         string::npos);
+  GRD.cleanup();
+
+  res = vertex_cover_brute(GNC, 6, [](VD vsrc) { return -1; });
+  assert(res);
+  ofs.open("petersen.gr", ofstream::out | ofstream::trunc);
+  out_pace_to_stream(ofs, GNC);
+  ofs.close();
+  ofs.open("petersen.vc", ofstream::out | ofstream::trunc);
+  out_pace_vc_to_stream(ofs, GNC, [](VD vd) { return vd->load.color == 2; });
+  ofs.close();
+
+  ostringstream vc;
+  out_pace_vc_to_stream(vc, GNC, [](VD vd) { return vd->load.color == 2; });
+  assert(vc.str().find("s vc 10 6\n") == 0);
+  GNC.cleanup();
+  remove_files({"petersen.gr", "petersen.vc"});
+
+  return 0;
+}
+
+bool is_cover(const VCProblem &p, const VCSolution &sol) {
+  vector<char> in(p.n, 0);
+  for (auto v : sol.cover)
+    in[v] = 1;
+  for (auto e : p.edges)
+    if (!in[e.first] && !in[e.second])
+      return false;
+  return sol.size == (int)sol.cover.size();
+}
+
+int test_batch(void) {
+  ifstream ifs;
+  vector<VCProblem> problems(3);
+  string names[] = {"petersen", "chvatal", "us"};
+  int sizes[] = {6, 7, 35};
+
+  for (int i = 0; i != 3; ++i) {
+    ifs.open(names[i] + string(".inp"), ifstream::in);
+    read_graph_from_stream(ifs, problems[i]);
+    ifs.close();
+  }
+
+  // sizes cross-checked with brute force for small graphs
+  GraphBuilder<colorload, colorload> GNC;
+  using VD = typename GraphBuilder<colorload, colorload>::VertexDescriptor;
+  ifs.open("chvatal.inp", ifstream::in);
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+  assert(!vertex_cover_brute(GNC, 6, [](VD vsrc) { return -1; }));
+  assert(vertex_cover_brute(GNC, 7, [](VD vsrc) { return -1; }));
+  GNC.cleanup();
+
+  VCWorkspace ws;
+  for (int i = 0; i != 3; ++i) {
+    VCSolution sol = ws.solve(problems[i]);
+    assert(is_cover(problems[i], sol));
+    assert(sol.lpbound <= sol.size);
+    assert(sol.size == sizes[i]);
+  }
+
+  // petersen LP is all-half: whole graph is kernel
+  ws.solve(problems[0]);
+  assert(ws.lp_kernel() == 10);
+  for (auto c : ws.lp_classes())
+    assert(c == 1);
+
+  // path 0-1-2 plus pendant 3 on 1: LP is integral, kernel is empty
+  VCProblem star;
+  star.add_isolated(4);
+  star.add_link(0, 1);
+  star.add_link(1, 2);
+  star.add_link(1, 3);
+  VCSolution ssol = ws.solve(star);
+  assert(ssol.size == 1 && ssol.nkernel == 0 && ssol.cover[0] == 1);
+
+  // kernel of us solved alone: LP is not rerun, forced part adds up
+  const VCProblem &us = problems[2];
+  ws.load(us);
+  ws.lp_kernel();
+  vector<int> cls = ws.lp_classes(), pos(us.n, -1);
+  VCProblem kern;
+  int forced = 0;
+  for (int v = 0; v != us.n; ++v)
+    if (cls[v] == 1) {
+      pos[v] = kern.n;
+      kern.add_isolated(1);
+    } else
+      forced += (cls[v] == 2);
+  for (auto e : us.edges)
+    if (pos[e.first] != -1 && pos[e.second] != -1)
+      kern.add_link(pos[e.first], pos[e.second]);
+  VCSolution ksol = ws.solve_kernel(kern);
+  assert(ksol.complete && is_cover(kern, ksol));
+  assert(forced + ksol.size == sizes[2] && ksol.nkernel == kern.n);
+  assert(ksol.lpbound == (kern.n + 1) / 2);
+
+  // long path with shuffled labels: augmenting paths are long, so
+  // recursive DFS would overflow call stack
+  const int npath = 1 << 20;
+  vector<int> label(npath);
+  for (int i = 0; i != npath; ++i)
+    label[i] = i;
+  Lcg rnd(2024);
+  for (int i = npath - 1; i > 0; --i)
+    std::swap(label[i], label[(rnd.next() >> 8) % (i + 1)]);
+  VCProblem path;
+  path.add_isolated(npath);
+  for (int i = 0; i + 1 != npath; ++i)
+    path.add_link(label[i], label[i + 1]);
+  ws.load(path);
+  assert(ws.lp_kernel() == npath);
+
+  vector<VCProblem> many;
+  for (int rep = 0; rep != 100; ++rep)
+    for (int i = 0; i != 3; ++i)
+      many.push_back(problems[i]);
+
+  VCPool pool(4);
+  vector<VCSolution> sols = vc_solve_batch(pool, many);
+  assert(sols.size() == many.size());
+  for (size_t i = 0; i != many.size(); ++i) {
+    assert(is_cover(many[i], sols[i]));
+    assert(sols[i].size == sizes[i % 3]);
+  }
+
+  std::atomic<int> nsolved{0};
+  vc_solve_batch(pool, many, [&](size_t idx, VCSolution &sol) {
+    assert(sol.size == sizes[idx % 3]);
+    nsolved += 1;
+  });
+  assert(nsolved == (int)many.size());
+
+  auto fut = pool.submit(problems[1]);
+  assert(fut.get().size == 7);
+
+  std::promise<int> cbres;
+  pool.submit(problems[0],
+              [&cbres](VCSolution sol) { cbres.set_value(sol.size); });
+  assert(cbres.get_future().get() == 6);
+
+  return 0;
+}
+
+int test_frozen(void) {
+  bool res;
+  GraphBuilder<colorload, colorload> GNC;
+  using FG = Graph<colorload, colorload>;
+  using FVD = typename FG::VertexDescriptor;
+
+  // same algorithms, same results on frozen graph
+  GNC.add_full_bipart(3, 5);
+  FG FB(GNC);
+  assert(FB.nvertices() == 8 && FB.narcs() == 30);
+  res = color_bipartite(FB);
+  assert(res);
+  assert(hopcroft_karp(FB) == 3);
+  assert(matching_to_cover(FB) == 3);
+  GNC.cleanup();
+
+  ifstream ifs;
+  ifs.open("petersen.inp", ifstream::in);
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+  FG FP(GNC);
+  assert(!color_bipartite(FP));
+  res = vertex_cover_brute(FP, 5, [](FVD vsrc) { return -1; });
+  assert(!res);
+  res = vertex_cover_brute(FP, 6, [](FVD vsrc) { return -1; });
+  assert(res);
+
+  // frozen graph writes the same as its builder
+  ostringstream bs, fs;
+  FG FS(GNC);
+  bs << GNC;
+  fs << FS;
+  assert(bs.str() == fs.str());
+  for (auto vd : FS)
+    assert(FS.degree(vd) == 3 && FS.vertex(FS.index(vd)) == vd);
+  auto e = FS.get_edge(FS.front(), FS.front()->arcs->tip);
+  assert(e && e->tip == FS.front()->arcs->tip);
+  assert(FS.get_sibling(e, FS.front())->tip == FS.front());
+  GNC.cleanup();
+
+  // from edge list: two paths, trivial solver
+  vector<pair<int, int>> edges{{0, 1}, {1, 2}, {3, 4}, {4, 5}, {5, 6}};
+  FG FE(7, edges);
+  for (auto vd : FE)
+    vd->load.color = 1;
+  auto cbf = [](FVD vd) {
+    int c = vd->load.color;
+    return (c == 0) ? 0 : (c == 2) ? 1 : -1;
+  };
+  auto cmf = [](FVD vd, int c) { vd->load.color = (c > 0) ? 2 : 0; };
+  int n = vertex_cover_trivial(FE, cbf, cmf);
+  assert(n == 3);
+  vertex_2approx(FE);
+  return 0;
+}
+
+int test_order(void) {
+  // 20x20 grid with scrambled labels
+  const int side = 20;
+  VCProblem grid;
+  grid.add_isolated(side * side);
+  auto label = [](int r, int c) {
+    return (r * side + c) * 37 % (side * side);
+  };
+  for (int r = 0; r != side; ++r)
+    for (int c = 0; c != side; ++c) {
+      if (c + 1 != side)
+        grid.add_link(label(r, c), label(r, c + 1));
+      if (r + 1 != side)
+        grid.add_link(label(r, c), label(r + 1, c));
+    }
+
+  auto adj = make_adjacency(grid);
+  auto before = order_stats(adj);
+  VertexOrder orders[] = {VertexOrder::natural, VertexOrder::degree,
+                          VertexOrder::bfs, VertexOrder::rcm,
+                          VertexOrder::gorder};
+  VCWorkspace ws;
+  VCProblem petersen;
+  ifstream ifs;
+  ifs.open("petersen.inp", ifstream::in);
+  read_graph_from_stream(ifs, petersen);
+  ifs.close();
+  auto padj = make_adjacency(petersen);
+
+  for (auto how : orders) {
+    auto order = vertex_order(adj, how);
+
+    // order is permutation
+    vector<int> seen(order.size(), 0);
+    for (auto v : order)
+      seen[v] += 1;
+    for (auto c : seen)
+      assert(c == 1);
+
+    VCProblem q = relabel(grid, order);
+    auto after = order_stats(make_adjacency(q));
+    if (how == VertexOrder::bfs || how == VertexOrder::rcm)
+      assert(after.bandwidth <= 2 * side);
+    if (how != VertexOrder::natural && how != VertexOrder::degree)
+      assert(after.avg_loggap < before.avg_loggap);
+
+    // cover on relabeled graph maps back to cover of original
+    auto porder = vertex_order(padj, how);
+    VCSolution sol = ws.solve(relabel(petersen, porder));
+    assert(sol.size == 6);
+    for (auto &v : sol.cover)
+      v = porder[v];
+    assert(is_cover(petersen, sol));
+  }
+
+  // frozen graph keeps original ids
+  GraphBuilder<colorload, colorload> GNC;
+  GNC.add_path(3);
+  GNC.add_clique(4);
+  auto order = vertex_order(GNC, VertexOrder::rcm);
+  Graph<colorload, colorload> FG(GNC, order);
+  for (auto vd : FG) {
+    auto ovd = GNC.vertex(FG.original(vd));
+    assert(FG.degree(vd) == GNC.degree(ovd));
+    for (auto e = vd->arcs; e != FG.last_edge(); e = e->next)
+      assert(GNC.get_edge(ovd, GNC.vertex(FG.original(e->tip))));
+  }
+  assert(order_stats(FG).bandwidth <= order_stats(GNC).bandwidth);
+  GNC.cleanup();
+  return 0;
+}
+
+int test_dense(void) {
+  bool res;
+  using DG = BitGraph<colorload, colorload>;
+  using DVD = typename DG::VertexDescriptor;
+
+  // same algorithms, same results on bit matrix
+  DG DB;
+  DB.add_full_bipart(3, 5);
+  assert(DB.nvertices() == 8);
+  res = color_bipartite(DB);
+  assert(res);
+  assert(hopcroft_karp(DB) == 3);
+  assert(matching_to_cover(DB) == 3);
+  assert(DB.common_degree(DB.vertex(0), DB.vertex(1)) == 5);
+  assert(!DB.adjacent(DB.vertex(0), DB.vertex(1)));
+  assert(DB.adjacent(DB.vertex(0), DB.vertex(7)));
+
+  // clique over word boundary
+  DG DC;
+  DC.add_isolated(60);
+  DC.add_clique(10);
+  for (int i = 60; i != 70; ++i)
+    assert(DC.degree(DC.vertex(i)) == 9);
+  assert(DC.degree(DC.vertex(0)) == 0);
+  assert(DC.common_degree(DC.vertex(61), DC.vertex(68)) == 8);
+  auto cbf = [&DC](DVD vd) { return (DC.index(vd) < 60) ? 0 : -1; };
+  res = vertex_cover_brute(DC, 8, cbf);
+  assert(!res);
+  res = vertex_cover_brute(DC, 9, cbf);
+  assert(res);
+
+  // any reader fills it, topology same as builder
+  GraphBuilder<colorload, colorload> GNC;
+  ifstream ifs;
+  ifs.open("petersen.inp", ifstream::in);
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+  DG DP(GNC);
+  assert(!color_bipartite(DP));
+  res = vertex_cover_brute(DP, 5, [](DVD vsrc) { return -1; });
+  assert(!res);
+  res = vertex_cover_brute(DP, 6, [](DVD vsrc) { return -1; });
+  assert(res);
+  for (auto vd : GNC)
+    for (auto ud : GNC) {
+      bool linked = GNC.get_edge(vd, ud) != GNC.last_edge();
+      auto dv = DP.vertex(GNC.index(vd)), du = DP.vertex(GNC.index(ud));
+      assert(linked == DP.adjacent(dv, du));
+      assert(linked == (bool)DP.get_edge(dv, du));
+    }
+
+  // edge loads are per arc, siblings are distinct
+  auto e = DP.get_edge(DP.front(), DP.front()->arcs->tip);
+  e->load.color = 1;
+  auto s = DP.get_sibling(e, DP.front());
+  assert(s->tip == DP.front() && s->load.color == 0);
+  s->load.color = 2;
+  assert(e->load.color == 1);
+
+  // repeated link keeps loads, new links and relaid rows move them
+  int tip = DP.index(e->tip);
+  DP.add_link(0, tip);
+  assert(e->load.color == 1 && s->load.color == 2);
+  DP.add_link(0, 2);
+  DP.add_isolated(60);
+  DP.add_link(0, 69);
+  e = DP.get_edge(DP.front(), DP.vertex(tip));
+  s = DP.get_sibling(e, DP.front());
+  assert(e->load.color == 1 && s->load.color == 2);
+  assert(DP.get_edge(DP.front(), DP.vertex(69))->load.color == 0);
+  DP.add_clique(5);
+  assert(DP.get_edge(DP.front(), DP.vertex(tip))->load.color == 1);
+  assert(DP.degree(DP.vertex(70)) == 4);
+  GNC.cleanup();
+  return 0;
+}
+
+// smallest cover by trying all subsets, for cross-checks
+int cover_exhaustive(const VCProblem &p) {
+  for (int k = 0; k <= p.n; ++k)
+    if (all_subsets(p.n, k, [&p](vector<int> &marks) {
+          for (auto e : p.edges)
+            if (!marks[e.first] && !marks[e.second])
+              return false;
+          return true;
+        }))
+      return k;
+  return p.n;
+}
+
+int test_bounds(void) {
+  VCWorkspace ws;
+  VCSolution sol;
+
+  // bipartite grid: LP kernel is everything, LP bound makes search exact
+  VCProblem grid;
+  grid.add_isolated(400);
+  for (int r = 0; r != 20; ++r)
+    for (int c = 0; c != 20; ++c) {
+      if (c + 1 != 20)
+        grid.add_link(r * 20 + c, r * 20 + c + 1);
+      if (r + 1 != 20)
+        grid.add_link(r * 20 + c, (r + 1) * 20 + c);
+    }
+  sol = ws.solve(grid);
+  assert(is_cover(grid, sol) && sol.size == 200 && sol.nkernel == 400);
+  assert(!ws.cover_within(grid, 199, sol));
+
+  // clique: LP says n/2, clique bound says n-1
+  VCProblem clique;
+  clique.add_isolated(40);
+  for (int i = 0; i != 40; ++i)
+    for (int j = i + 1; j != 40; ++j)
+      clique.add_link(i, j);
+  assert(!ws.cover_within(clique, 38, sol));
+  assert(ws.cover_within(clique, 39, sol) && is_cover(clique, sol));
+  assert(sol.size == 39);
+
+  // decision queries agree with exhaustive search on random graphs
+  Lcg rnd(12345);
+  for (int rep = 0; rep != 200; ++rep) {
+    VCProblem p;
+    p.add_isolated(4 + rnd(9));
+    int m = rnd(3 * p.n);
+    for (int i = 0; i != m; ++i) {
+      int u = rnd(p.n), v = rnd(p.n);
+      if (u != v)
+        p.add_link(u, v);
+    }
+    int opt = cover_exhaustive(p);
+    sol = ws.solve(p);
+    assert(is_cover(p, sol) && sol.size == opt);
+    if (opt > 0)
+      assert(!ws.cover_within(p, opt - 1, sol));
+    assert(ws.cover_within(p, opt, sol) && is_cover(p, sol));
+    assert(sol.size <= opt);
+  }
+
+  // fixed vertices: petersen with vertex 0 out of cover needs its
+  // neighbors and still 6 in total
+  GraphBuilder<colorload, colorload> GNC;
+  using VD = typename GraphBuilder<colorload, colorload>::VertexDescriptor;
+  ifstream ifs;
+  ifs.open("petersen.inp", ifstream::in);
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+  auto cbf = [&GNC](VD vd) { return (GNC.index(vd) == 0) ? 0 : -1; };
+  assert(!vertex_cover_brute(GNC, 5, cbf));
+  assert(vertex_cover_brute(GNC, 6, cbf));
+  assert(GNC.front()->load.color == 0);
+  for (auto vd : GNC)
+    for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+      assert(vd->load.color == 2 || ed->tip->load.color == 2);
+  GNC.cleanup();
+  return 0;
+}
+
+int test_dynamic(void) {
+  GraphBuilder<colorload, colorload> GNC;
+  ifstream ifs;
+  ifs.open("petersen.inp", ifstream::in);
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+
+  // petersen is perfect in double, all-half LP
+  DynamicMatching<colorload, colorload> dm(GNC);
+  assert(dm.matching() == 10 && dm.lp_bound() == 5);
+  for (auto c : dm.lp_classes())
+    assert(c == 1);
+  GNC.cleanup();
+
+  // classes cover new vertices, added here or straight to graph
+  GNC.add_path(3);
+  DynamicMatching<colorload, colorload> dp(GNC);
+  assert(dp.lp_classes() == vector<int>({0, 2, 0}));
+  assert(dp.add_vertex() == 3);
+  assert(dp.lp_classes() == vector<int>({0, 2, 0, 0}));
+  GNC.add_isolated(1);
+  assert(dp.lp_classes().size() == 5);
+  GNC.cleanup();
+
+  // random updates agree with static solver after every step
+  auto snapshot = [&GNC]() {
+    VCProblem p;
+    p.add_isolated(GNC.nvertices());
+    for (auto vd : GNC)
+      for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+        if (GNC.index(vd) < GNC.index(ed->tip))
+          p.add_link(GNC.index(vd), GNC.index(ed->tip));
+    return p;
+  };
+
+  GNC.add_isolated(30);
+  DynamicMatching<colorload, colorload> dyn(GNC);
+  assert(dyn.matching() == 0);
+  VCWorkspace ws;
+  vector<pair<int, int>> present;
+  Lcg rnd(777);
+  for (int step = 0; step != 600; ++step) {
+    if (present.empty() || rnd(3) != 0) {
+      int u = rnd(30), v = rnd(30);
+      if (u == v)
+        continue;
+      dyn.insert(u, v);
+      present.emplace_back(u, v);
+    } else {
+      int i = rnd(present.size());
+      assert(dyn.remove(present[i].first, present[i].second));
+      present.erase(present.begin() + i);
+    }
+    if (step == 300)
+      dyn.add_vertex();
+
+    VCProblem p = snapshot();
+    ws.load(p);
+    assert(dyn.matching() == ws.lp_kernel());
+    assert(dyn.lp_classes() == ws.lp_classes());
+  }
+  assert(!dyn.remove(0, 0));
+  GNC.cleanup();
+  return 0;
+}
+
+int test_stream(void) {
+  // star in PACE form: comments and header are skipped, ids taken as is
+  StreamCover sc;
+  istringstream star("c star\np td 5 4\n1 2\n1 3\n1 4\n1 5\n");
+  assert(sc.read(star) == 4);
+  assert(sc.nvertices() == 6 && sc.lower_bound() == 1);
+  assert(sc.cover() == vector<int>({1, 2}));
+  star.clear();
+  star.seekg(0);
+  assert(sc.prune(star) == 4);
+  assert(sc.cover() == vector<int>({1}));
+
+  // random graphs: both covers are valid, bounded by exact answer
+  Lcg rnd(4242);
+  for (int iter = 0; iter != 100; ++iter) {
+    VCProblem p;
+    p.add_isolated(12);
+    ostringstream os;
+    for (int i = 0, m = rnd(30); i != m; ++i) {
+      int u = rnd(12), v = rnd(12);
+      if (u == v)
+        continue;
+      p.add_link(u, v);
+      os << "e " << u << " " << v << "\n";
+    }
+    VCSolution sol;
+    istringstream is(os.str());
+    sc.cleanup();
+    sc.read(is);
+    sol.cover = sc.cover();
+    sol.size = sc.cover_size();
+    p.n = std::max(p.n, sc.nvertices());
+    assert(is_cover(p, sol) && sol.size == 2 * sc.lower_bound());
+    is.clear();
+    is.seekg(0);
+    sc.prune(is);
+    int opt = cover_exhaustive(p);
+    assert(sc.lower_bound() <= opt && opt <= sc.cover_size());
+    assert(sc.cover_size() <= sol.size);
+    sol.cover = sc.cover();
+    sol.size = sc.cover_size();
+    assert(is_cover(p, sol));
+  }
+
+  // both passes over file
+  GraphBuilder<colorload, colorload> GNC;
+  ifstream ifs("chvatal.inp");
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+  ofstream ofs("chvatal_stream.gr");
+  out_pace_to_stream(ofs, GNC);
+  ofs.close();
+  assert(KGR::stream_cover_file("chvatal_stream.gr", sc));
+  assert(sc.lower_bound() <= 7 && sc.cover_size() >= 7);
+  assert(sc.cover_size() < 2 * sc.lower_bound());
+  assert(!KGR::stream_cover_file("no_such_file.gr", sc));
+  GNC.cleanup();
+  remove_files({"chvatal_stream.gr"});
+  return 0;
+}
+
+int test_mapped(void) {
+  GraphBuilder<colorload, colorload> GNC;
+  using MGraph = MappedGraph<colorload, colorload>;
+  MGraph MG;
+  ifstream ifs("petersen.inp");
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+
+  // same rows, sorted, with parallel edge merged and loop dropped
+  GNC.add_link(0, 1);
+  GNC.add_link(4, 4);
+  assert(MG.write("petersen.kgm", GNC));
+  assert(MG.open("petersen.kgm"));
+  assert(MG.nvertices() == 10 && MG.narcs() == 30);
+  for (auto vd : MG) {
+    int prev = -1;
+    for (auto ed = vd->arcs; ed != MG.last_edge(); ed = ed->next) {
+      int w = MG.index(ed->tip);
+      assert(w > prev);
+      prev = w;
+      assert(GNC.get_edge(GNC.vertex(MG.index(vd)), GNC.vertex(w)) !=
+             GNC.last_edge());
+      assert(MG.get_sibling(ed, vd) != MG.last_edge());
+    }
+    assert(MG.degree(vd) == 3);
+  }
+
+  // algorithms run on mapped loads, state survives reopening
+  assert(!color_bipartite(MG));
+  vertex_2approx(MG);
+  for (auto vd : MG)
+    for (auto ed = vd->arcs; ed != MG.last_edge(); ed = ed->next)
+      assert(vd->load.color == 1 || ed->tip->load.color == 1);
+  int cover = 0;
+  for (auto vd : MG)
+    cover += vd->load.color;
+  MG.flush();
+  assert(MG.open("petersen.kgm"));
+  for (auto vd : MG)
+    cover -= vd->load.color;
+  assert(cover == 0);
+
+  // LP kernel borrows mapped arrays
+  VCWorkspace ws;
+  assert(ws.load_csr(MG.nvertices(), MG.offsets(), MG.targets()));
+  assert(ws.lp_kernel() == 10);
+  uint64_t huge[] = {0, uint64_t(1) << 31};
+  assert(!ws.load_csr(1, huge, MG.targets()));
+
+  // two-pass build from edge list file gives same topology
+  ofstream ofs("petersen.el");
+  ofs << "c edges with repeat and loop\ne 4 4\n";
+  for (auto vd : GNC)
+    for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+      ofs << GNC.index(vd) << " " << GNC.index(ed->tip) << "\n";
+  ofs.close();
+  MGraph MB;
+  assert(MGraph::build("petersen.kgb", "petersen.el"));
+  assert(MB.open("petersen.kgb"));
+  assert(MB.nvertices() == 10 && MB.narcs() == 30);
+  assert(std::equal(MG.offsets(), MG.offsets() + 11, MB.offsets()));
+  assert(std::equal(MG.targets(), MG.targets() + 30, MB.targets()));
+  for (auto vd : MB)
+    assert(vd->load.color == 0);
+  MG.close();
+  GNC.cleanup();
+
+  // edge source: n adds isolated vertices, source shall repeat itself
+  auto path3 = [](auto f) {
+    f(0, 1);
+    f(2, 1);
+    f(1, 0);
+  };
+  assert(MGraph::build("path.kgb", path3, 5));
+  assert(MB.open("path.kgb"));
+  assert(MB.nvertices() == 5 && MB.narcs() == 4);
+  assert(MB.degree(MB.vertex(1)) == 2 && MB.degree(MB.vertex(4)) == 0);
+  int calls = 0;
+  auto unstable = [&calls](auto f) {
+    f(0, 1);
+    if (calls++ == 0)
+      f(1, 2);
+  };
+  assert(!MGraph::build("bad.kgb", unstable));
+  assert(!MGraph::build("bad.kgb", "no_such.el"));
+  MB.close();
+
+  // matching and cover on bipartite graph, same as in memory
+  add_bipart_fixture(GNC);
+  assert(MG.write("bipart.kgm", GNC));
+  assert(MG.open("bipart.kgm"));
+  MG.advise(KGR::MapAccess::random);
+  check_bipart_fixture(MG, GNC);
+  MG.close();
+  GNC.cleanup();
+
+  assert(!MG.open("no_such_file.kgm"));
+  assert(!MG.open("petersen.inp"));
+  for (auto base : {"petersen.kgm", "petersen.kgb", "path.kgb", "bad.kgb",
+                    "bipart.kgm"}) {
+    string name(base);
+    remove_files({base, (name + ".vl").c_str(), (name + ".el").c_str()});
+  }
+  remove_files({"petersen.el"});
+  return 0;
+}
+
+int test_packed(void) {
+  // random rows with repeats, far and near tips on both sides
+  GraphBuilder<colorload, colorload> GNC;
+  GNC.add_isolated(1000);
+  Lcg rnd(99);
+  for (int i = 0; i != 3000; ++i) {
+    int u = rnd(1000), v = (i % 2) ? rnd(1000) : (u + 1 + rnd(3)) % 1000;
+    if (u != v)
+      GNC.add_link(u, v);
+  }
+  for (auto vd : GNC)
+    vd->load.color = GNC.index(vd) % 3;
+
+  PackedGraph<colorload, colorload> PG(GNC);
+  assert(PG.nvertices() == 1000);
+  int narcs = 0;
+  vector<int> tips;
+  for (auto vd : PG) {
+    auto src = GNC.vertex(PG.index(vd));
+    set<int> expect;
+    for (auto ed = src->arcs; ed != GNC.last_edge(); ed = ed->next)
+      expect.insert(GNC.index(ed->tip));
+    PG.decode_row(PG.index(vd), tips);
+    assert(tips == vector<int>(expect.begin(), expect.end()));
+    assert(PG.degree(vd) == (int)tips.size());
+    assert(vd->load.color == src->load.color);
+    for (auto t : tips)
+      assert(PG.get_edge(vd, PG.vertex(t)) != PG.last_edge());
+    narcs += tips.size();
+  }
+  assert(PG.narcs() == narcs);
+  assert(PG.get_edge(PG.vertex(0), PG.vertex(0)) == PG.last_edge());
+  assert(PG.adjacency_bytes() < narcs * sizeof(int));
+
+  // edge loads follow arcs
+  auto e = PG.get_edge(PG.vertex(0), PG.front()->arcs->tip);
+  e->load.color = 5;
+  assert(PG.front()->arcs->load.color == 5);
+
+  vertex_2approx(PG);
+  for (auto vd : PG)
+    for (auto ed = vd->arcs; ed != PG.last_edge(); ed = ed->next)
+      assert(vd->load.color == 1 || ed->tip->load.color == 1);
+  GNC.cleanup();
+
+  // matching and cover on bipartite graph, same as in memory
+  add_bipart_fixture(GNC);
+  PackedGraph<colorload, colorload> PB(GNC);
+  check_bipart_fixture(PB, GNC);
+  GNC.cleanup();
+
+  // edge list, no edge loads stored
+  PackedGraph<colorload, noload> PN(4, {{0, 3}, {3, 0}, {1, 2}});
+  assert(PN.narcs() == 4 && PN.degree(PN.vertex(3)) == 1);
+  assert(color_bipartite(PN));
+  return 0;
+}
+
+int test_bulk(void) {
+  // random pairs with repeats in both orientations
+  const int n = 500;
+  vector<pair<int, int>> edges;
+  vector<set<int>> expect(n);
+  Lcg rnd(31337);
+  for (int i = 0; i != 6000; ++i) {
+    int u = rnd(n), v = (i % 3) ? rnd(n) : (u + 1) % n;
+    if (u == v)
+      continue;
+    edges.emplace_back(u, v);
+    if (i % 5 == 0)
+      edges.emplace_back(v, u);
+    expect[u].insert(v);
+    expect[v].insert(u);
+  }
+
+  for (int nthreads : {1, 3, 4}) {
+    vector<uint32_t> offsets, targets;
+    KGR::bulk_csr(n, edges.data(), edges.size(), nthreads, offsets, targets);
+    assert((int)offsets.size() == n + 1 && offsets[n] == targets.size());
+    for (int v = 0; v != n; ++v)
+      assert(vector<uint32_t>(targets.begin() + offsets[v],
+                              targets.begin() + offsets[v + 1]) ==
+             vector<uint32_t>(expect[v].begin(), expect[v].end()));
+
+    Graph<colorload, colorload> G(n, edges.data(), edges.size(), nthreads);
+    assert(G.nvertices() == n && G.narcs() == (int)targets.size());
+    for (auto vd : G) {
+      vector<int> row;
+      for (auto ed = vd->arcs; ed != G.last_edge(); ed = ed->next)
+        row.push_back(G.index(ed->tip));
+      assert(row == vector<int>(expect[G.index(vd)].begin(),
+                                expect[G.index(vd)].end()));
+    }
+  }
+
+  // builder gets every edge once, next to what it had
+  GraphBuilder<colorload, colorload> GNC;
+  GNC.add_isolated(n);
+  GNC.add_link(0, 1);
+  GNC.add_edges_bulk(edges.data(), edges.size(), 2);
+  for (auto vd : GNC) {
+    std::multiset<int> row;
+    for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+      row.insert(GNC.index(ed->tip));
+    std::multiset<int> want(expect[GNC.index(vd)].begin(),
+                       expect[GNC.index(vd)].end());
+    if (GNC.index(vd) < 2)
+      want.insert(1 - GNC.index(vd));
+    assert(row == want);
+  }
+  GNC.cleanup();
+
+  // nothing to sort
+  Graph<noload, noload> E(3, edges.data(), 0, 2);
+  assert(E.nvertices() == 3 && E.narcs() == 0);
+  return 0;
+}
+
+int test_index(void) {
+  // hub 0 with 300 leaves, parallel link 0-1 made before index
+  GraphBuilder<colorload, colorload> GNC;
+  GNC.add_isolated(301);
+  for (int v = 1; v <= 300; ++v)
+    GNC.add_link(0, v);
+  GNC.add_link(0, 1);
+  GNC.add_link(1, 2);
+  auto hub = GNC.vertex(0);
+  auto scan = [&GNC](int u, int v) {
+    for (auto e = GNC.vertex(u)->arcs; e != nullptr; e = e->next)
+      if (GNC.index(e->tip) == v)
+        return e;
+    return (decltype(GNC.last_edge()))nullptr;
+  };
+
+  GNC.set_hub_degree(8);
+  assert(GNC.degree(hub) == 301);
+  for (int v = 0; v <= 300; ++v) {
+    assert(GNC.get_edge(hub, GNC.vertex(v)) == scan(0, v));
+    assert(GNC.get_edge(GNC.vertex(v), hub) == scan(v, 0));
+  }
+  auto e = GNC.get_edge(hub, GNC.vertex(7));
+  assert(GNC.get_sibling(e, hub) == scan(7, 0));
+
+  // duplicates rejected in both directions, new links indexed
+  assert(!GNC.add_link(0, 5) && !GNC.add_link(5, 0) && !GNC.add_link(2, 1));
+  assert(GNC.degree(hub) == 301);
+  assert(GNC.add_link(5, 6) && GNC.get_edge(GNC.vertex(6), GNC.vertex(5)));
+
+  // parallel arc takes place of removed one
+  assert(GNC.remove_link(0, 1));
+  assert(GNC.get_edge(hub, GNC.vertex(1)) == scan(0, 1) && scan(0, 1));
+  assert(GNC.remove_link(0, 1));
+  assert(!GNC.get_edge(hub, GNC.vertex(1)) && !GNC.remove_link(1, 0));
+  assert(GNC.degree(hub) == 299 && GNC.add_link(1, 0));
+
+  // tips are rewritten by double and back, index follows
+  GNC.duplicate_to_bipart([](VD) {});
+  assert(GNC.get_edge(hub, GNC.vertex(301 + 9)) == scan(0, 301 + 9));
+  assert(!GNC.get_edge(hub, GNC.vertex(9)));
+  GNC.join_from_bipart([](VD, VD) {});
+  assert(GNC.get_edge(hub, GNC.vertex(9)) == scan(0, 9));
+
+  // without index everything is linear again, duplicates accepted
+  GNC.set_hub_degree(0);
+  assert(GNC.add_link(0, 5) && GNC.degree(hub) == 301);
+  GNC.cleanup();
+
+  // bulk with index skips links already there
+  GNC.set_hub_degree(2);
+  GNC.add_isolated(4);
+  GNC.add_link(0, 1);
+  vector<pair<int, int>> edges{{1, 0}, {0, 2}, {2, 0}, {3, 0}};
+  GNC.add_edges_bulk(edges.data(), edges.size());
+  assert(GNC.degree(GNC.vertex(0)) == 3);
+  GNC.cleanup();
+  return 0;
+}
+
+// every edge in some bag, bags of each vertex connected through parents
+bool is_decomposition(const VCProblem &p, const KGR::TreeDecomposition &td) {
+  vector<set<int>> bags(td.bags.size());
+  for (size_t t = 0; t != td.bags.size(); ++t)
+    bags[t].insert(td.bags[t].begin(), td.bags[t].end());
+  for (auto e : p.edges) {
+    bool found = false;
+    for (auto &b : bags)
+      found = found || (b.count(e.first) && b.count(e.second));
+    if (!found)
+      return false;
+  }
+  // each vertex has exactly one bag whose parent misses it
+  vector<int> tops(p.n, 0);
+  for (size_t t = 0; t != bags.size(); ++t)
+    for (auto v : bags[t])
+      if (td.parent[t] == -1 || !bags[td.parent[t]].count(v))
+        tops[v] += 1;
+  for (auto c : tops)
+    if (c != 1)
+      return false;
+  return true;
+}
+
+int test_treedec(void) {
+  using KGR::Elimination;
+  KGR::TreeDecomposition td;
+  VCSolution sol;
+  string names[] = {"petersen", "chvatal", "us"};
+  int sizes[] = {6, 7, 35};
+  for (int i = 0; i != 3; ++i) {
+    VCProblem p;
+    ifstream ifs(names[i] + ".inp");
+    read_graph_from_stream(ifs, p);
+    for (auto how : {Elimination::min_degree, Elimination::min_fill}) {
+      assert(KGR::tree_decomposition(p, how, td));
+      assert(is_decomposition(p, td));
+      KGR::treedec_solve(p, td, sol);
+      assert(is_cover(p, sol) && sol.size == sizes[i]);
+    }
+  }
+
+  // random small graphs against exhaustive search
+  Lcg rnd(777);
+  for (int rep = 0; rep != 200; ++rep) {
+    VCProblem p;
+    p.add_isolated(1 + rnd(12));
+    int m = rnd(3 * p.n);
+    for (int i = 0; i != m; ++i) {
+      int u = rnd(p.n), v = rnd(p.n);
+      if (u != v)
+        p.add_link(u, v);
+    }
+    auto how = (rep & 1) ? Elimination::min_fill : Elimination::min_degree;
+    assert(KGR::vc_treedec(p, sol, 16, how));
+    assert(is_cover(p, sol) && sol.size == cover_exhaustive(p));
+  }
+
+  // narrow grid: greedy width stays near its short side, cover is half
+  VCProblem grid;
+  grid.add_isolated(8 * 300);
+  for (int r = 0; r != 300; ++r)
+    for (int c = 0; c != 8; ++c) {
+      if (c + 1 != 8)
+        grid.add_link(r * 8 + c, r * 8 + c + 1);
+      if (r + 1 != 300)
+        grid.add_link(r * 8 + c, (r + 1) * 8 + c);
+    }
+  assert(KGR::tree_decomposition(grid, Elimination::min_fill, td));
+  assert(is_decomposition(grid, td) && td.width() <= 12);
+  KGR::treedec_solve(grid, td, sol);
+  assert(is_cover(grid, sol) && sol.size == 8 * 300 / 2);
+  assert(!KGR::vc_treedec(grid, sol, 4));
+
+  // decision backend agrees with brute one, also with fixed vertex
+  GraphBuilder<colorload, colorload> GNC;
+  using VD = typename GraphBuilder<colorload, colorload>::VertexDescriptor;
+  ifstream ifs("petersen.inp");
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+  auto any = [](VD) { return -1; };
+  auto cbf = [&GNC](VD vd) { return (GNC.index(vd) == 0) ? 0 : -1; };
+  assert(!vertex_cover_treedec(GNC, 5, any));
+  assert(vertex_cover_treedec(GNC, 6, any));
+  assert(!vertex_cover_treedec(GNC, 5, cbf));
+  assert(vertex_cover_treedec(GNC, 6, cbf, 2));
+  assert(GNC.front()->load.color == 0);
+  for (auto vd : GNC)
+    for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+      assert(vd->load.color == 2 || ed->tip->load.color == 2);
+  GNC.cleanup();
+  return 0;
+}
+
+// gadgets for compile-time checks, vertices from 0
+constexpr int petersen_edges[][2] = {
+    {0, 1}, {0, 4}, {0, 5}, {1, 2}, {1, 6}, {2, 3}, {2, 7}, {3, 4},
+    {3, 8}, {4, 9}, {5, 7}, {5, 8}, {6, 9}, {6, 8}, {7, 9}};
+constexpr int chvatal_edges[][2] = {
+    {0, 1},  {0, 11}, {1, 2},  {1, 5},   {1, 7},  {2, 3},   {2, 8},
+    {2, 10}, {3, 4},  {4, 5},  {4, 8},   {4, 10}, {5, 6},   {5, 11},
+    {6, 7},  {7, 8},  {7, 11}, {8, 9},   {9, 10}, {10, 11}};
+
+int test_static(void) {
+  constexpr auto SP = KGR::make_static_graph<10>(petersen_edges);
+  constexpr auto SC = KGR::make_static_graph<12>(chvatal_edges);
+  static_assert(SP.narcs() == 30 && SP.min_cover_size() == 6, "petersen");
+  static_assert(SP.is_cover(SP.min_cover()), "petersen cover");
+  static_assert(SC.min_cover_size() == 7, "chvatal");
+  static_assert(SC.neighbors(0) == ((1u << 1) | (1u << 11)), "chvatal row");
+  constexpr KGR::SmallCovers<5> small{};
+  static_assert(small.cover[0] == 0, "no edges");
+  static_assert(__builtin_popcount(small.cover[(1 << 10) - 1]) == 4, "K5");
+
+  // copy on stack has loads, arc order same as Graph from edge list
+  auto SPC = KGR::StaticGraph<10, 15, colorload, colorload>(petersen_edges);
+  using SVD = decltype(SPC)::VertexDescriptor;
+  vector<pair<int, int>> edges;
+  for (auto &e : petersen_edges)
+    edges.emplace_back(e[0], e[1]);
+  Graph<colorload, colorload> G(10, edges);
+  for (int v = 0; v != 10; ++v) {
+    auto sa = SPC.vertex(v)->arcs;
+    auto ga = G.vertex(v)->arcs;
+    for (; ga != G.last_edge(); ga = ga->next, sa = sa->next)
+      assert(sa != SPC.last_edge() && SPC.index(sa->tip) == G.index(ga->tip));
+    assert(sa == SPC.last_edge());
+    assert(SPC.degree(SPC.vertex(v)) == 3);
+  }
+  assert(SPC.get_edge(SPC.vertex(6), SPC.vertex(8)) != SPC.last_edge());
+  assert(SPC.get_edge(SPC.vertex(6), SPC.vertex(7)) == SPC.last_edge());
+
+  // algorithms from KGAlg.hpp
+  assert(!color_bipartite(SPC));
+  assert(!vertex_cover_brute(SPC, 5, [](SVD) { return -1; }));
+  assert(vertex_cover_brute(SPC, 6, [](SVD) { return -1; }));
+  int ncover = 0;
+  for (auto vd : SPC) {
+    ncover += (vd->load.color == 2);
+    for (auto ed = vd->arcs; ed != SPC.last_edge(); ed = ed->next)
+      assert(vd->load.color == 2 || ed->tip->load.color == 2);
+  }
+  assert(ncover == 6);
+
+  // table against exhaustive search, graphs on k <= 5 vertices
+  for (uint32_t emask = 0; emask != (1u << 10); ++emask)
+    for (int k = 1; k <= 5; ++k) {
+      if (emask >= (1u << (k * (k - 1) / 2)))
+        continue;
+      VCProblem p;
+      p.add_isolated(k);
+      for (int j = 1; j != k; ++j)
+        for (int i = 0; i != j; ++i)
+          if ((emask >> small.pair_bit(i, j)) & 1)
+            p.add_link(i, j);
+      uint32_t c = small.cover[emask];
+      assert(c < (1u << k) && __builtin_popcount(c) == cover_exhaustive(p));
+      for (auto e : p.edges)
+        assert(((c >> e.first) | (c >> e.second)) & 1);
+    }
+  return 0;
+}
+
+int test_minimize(void) {
+  using VD = typename GraphBuilder<colorload, colorload>::VertexDescriptor;
+  string names[] = {"petersen", "chvatal", "us"};
+  int sizes[] = {6, 7, 35};
+  for (int i = 0; i != 3; ++i) {
+    GraphBuilder<colorload, colorload> GNC;
+    ifstream ifs(names[i] + ".inp");
+    read_graph_from_stream(ifs, GNC);
+    KGR::VCProof proof;
+    assert(min_vertex_cover(GNC, proof) == sizes[i]);
+    assert(proof.lower <= sizes[i] && sizes[i] <= proof.upper);
+    assert(proof.upper <= 2 * sizes[i]);
+    int ncover = 0;
+    for (auto vd : GNC) {
+      ncover += (vd->load.color == 2);
+      for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+        assert(vd->load.color == 2 || ed->tip->load.color == 2);
+    }
+    assert(ncover == sizes[i]);
+
+    // petersen: all-half LP gives 5, so size 5 is refuted by search
+    if (i == 0)
+      assert(proof.lower == 5 && !proof.by_bound);
+    GNC.cleanup();
+  }
+
+  // bipartite grid: LP closes gap, no refutation needed
+  VCWorkspace ws;
+  VCProblem grid;
+  grid.add_isolated(400);
+  for (int r = 0; r != 20; ++r)
+    for (int c = 0; c != 20; ++c) {
+      if (c + 1 != 20)
+        grid.add_link(r * 20 + c, r * 20 + c + 1);
+      if (r + 1 != 20)
+        grid.add_link(r * 20 + c, (r + 1) * 20 + c);
+    }
+  KGR::VCProof proof;
+  VCSolution sol = ws.minimize(grid, proof);
+  assert(is_cover(grid, sol) && sol.size == 200);
+  assert(proof.by_bound && proof.lower == 200);
+
+  // random graphs against exhaustive search, same workspace reused
+  Lcg rnd(4242);
+  for (int rep = 0; rep != 200; ++rep) {
+    VCProblem p;
+    p.add_isolated(1 + rnd(12));
+    int m = rnd(3 * p.n);
+    for (int i = 0; i != m; ++i) {
+      int u = rnd(p.n), v = rnd(p.n);
+      if (u != v)
+        p.add_link(u, v);
+    }
+    sol = ws.minimize(p, proof);
+    int opt = cover_exhaustive(p);
+    assert(is_cover(p, sol) && sol.size == opt);
+    assert(proof.lower <= opt && opt <= proof.upper);
+    assert(proof.by_bound == (proof.lower == opt));
+  }
+
+  // same answer as k-loop over decisions
+  GraphBuilder<colorload, colorload> GNC;
+  ifstream ifs("chvatal.inp");
+  read_graph_from_stream(ifs, GNC);
+  int k = 1;
+  while (!vertex_cover_brute(GNC, k, [](VD) { return -1; }))
+    k += 1;
+  assert(min_vertex_cover(GNC, proof) == k);
+  GNC.cleanup();
+  return 0;
+}
+
+int test_budget(void) {
+  using KGR::SolveBudget;
+  using KGR::VCProgress;
+
+  // cancelled before start: matching stays empty, edges uncolored
+  GraphBuilder<colorload, colorload> GNC;
+  ifstream ifs("us.inp");
+  read_graph_from_stream(ifs, GNC);
+  ifs.close();
+  GNC.duplicate_to_bipart([](VD vsrc) {});
+  for (auto vd : GNC)
+    for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+      ed->load.color = 0;
+  SolveBudget cancelled;
+  cancelled.cancel();
+  assert(hopcroft_karp(GNC, &cancelled) == 0);
+  for (auto vd : GNC)
+    for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+      assert(ed->load.color == 0);
+  GNC.cleanup();
+
+  // past deadline is seen at first clock read
+  SolveBudget late;
+  late.set_deadline(SolveBudget::clock::now() - std::chrono::seconds(1));
+  int nsubsets = 0;
+  assert(!all_subsets(40, 20, [&nsubsets](vector<int> &) {
+    nsubsets += 1;
+    return false;
+  }, &late));
+  assert(late.stopped() && nsubsets < (int)SolveBudget::check_every);
+
+  // hard random instance, stopped from progress callback: best known
+  // cover is still a cover and lower bound holds
+  Lcg rnd(99);
+  VCProblem p;
+  p.add_isolated(300);
+  for (int i = 0; i != 900; ++i) {
+    int u = rnd(p.n), v = rnd(p.n);
+    if (u != v)
+      p.add_link(u, v);
+  }
+  SolveBudget budget;
+  vector<VCProgress> reports;
+  budget.on_progress(
+      [&reports, &budget](const VCProgress &pr) {
+        // LP kernel reports before any bound is known
+        if (pr.upper == -1)
+          return;
+        reports.push_back(pr);
+        if (reports.size() == 3)
+          budget.cancel();
+      },
+      SolveBudget::clock::duration(0));
+  VCWorkspace ws;
+  ws.set_budget(&budget);
+  KGR::VCProof proof;
+  VCSolution sol = ws.minimize(p, proof);
+  assert(!sol.complete && reports.size() == 3);
+  assert(is_cover(p, sol) && proof.lower <= sol.size);
+  assert(sol.size <= proof.upper);
+  for (auto &pr : reports)
+    assert(pr.lower == proof.lower && pr.upper >= sol.size);
+  assert(!ws.cover_within(p, proof.lower, sol) && !sol.complete);
+
+  // same workspace without budget runs to the end on small instance
+  ws.set_budget(nullptr);
+  VCProblem small;
+  small.add_isolated(12);
+  for (int i = 0; i != 30; ++i) {
+    int u = rnd(small.n), v = rnd(small.n);
+    if (u != v)
+      small.add_link(u, v);
+  }
+  sol = ws.solve(small);
+  assert(sol.complete && sol.size == cover_exhaustive(small));
+
+  // LP kernel polls too: stopped before start, nothing is decided and
+  // whole graph is cover
+  ws.set_budget(&cancelled);
+  sol = ws.solve(small);
+  assert(!sol.complete && sol.nkernel == small.n && sol.size == small.n);
+  for (auto c : ws.lp_classes())
+    assert(c == 1);
+  ws.set_budget(nullptr);
+  assert(ws.solve(small).complete);
+
+  // cancellation from other thread
+  SolveBudget remote;
+  ws.set_budget(&remote);
+  std::thread stopper([&remote] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    remote.cancel();
+  });
+  sol = ws.minimize(p, proof);
+  stopper.join();
+  assert(is_cover(p, sol) && proof.lower <= sol.size);
+  return 0;
+}
+
+int test_pipeline(void) {
+  // copy of petersen gets its .vc written, originals are only solved
+  {
+    ifstream ifs("petersen.inp");
+    ofstream ofs("pipe_petersen.inp", ofstream::out | ofstream::trunc);
+    ofs << ifs.rdbuf();
+  }
+  vector<string> inputs = KGR::list_files(".", ".inp");
+  assert(std::find(inputs.begin(), inputs.end(), "./pipe_petersen.inp") !=
+         inputs.end());
+  assert(std::is_sorted(inputs.begin(), inputs.end()));
+
+  KGR::PipelineConfig cfg;
+  cfg.nsolve = 2;
+  cfg.queue_size = 2;
+  vector<string> one{"./pipe_petersen.inp"};
+  KGR::PipelineReport rep = KGR::vc_pipeline(one, cfg);
+  assert(rep.nfailed == 0 && rep.stages[3].items == 1);
+  ifstream vcs("pipe_petersen.vc");
+  string header;
+  getline(vcs, header);
+  assert(header == "s vc 10 6");
+  VCProblem pp;
+  ifstream pin("pipe_petersen.inp");
+  read_graph_from_stream(pin, pp);
+  VCSolution psol;
+  for (int v; vcs >> v;)
+    psol.cover.push_back(v - 1);
+  psol.size = psol.cover.size();
+  assert(psol.size == 6 && is_cover(pp, psol));
+
+  // output directory missing: solved, but counted as not written
+  cfg.out_dir = "no_such_dir";
+  rep = KGR::vc_pipeline(one, cfg);
+  assert(rep.nfailed == 0 && rep.nunwritten == 1);
+
+  // many files through small queues, results out of order, one missing
+  vector<string> paths;
+  vector<int> sizes;
+  string names[] = {"petersen", "chvatal", "us"};
+  int expect[] = {6, 7, 35};
+  for (int copy = 0; copy != 40; ++copy)
+    for (int i = 0; i != 3; ++i) {
+      paths.push_back(names[i] + ".inp");
+      sizes.push_back(expect[i]);
+    }
+  paths.push_back("no_such_file.inp");
+  sizes.push_back(0);
+
+  cfg.out_dir = "-";
+  cfg.nload = 2;
+  cfg.nkernel = 2;
+  cfg.nwrite = 2;
+  std::mutex mutex;
+  vector<int> seen(paths.size(), 0);
+  rep = KGR::vc_pipeline(paths, cfg,
+                         [&](size_t idx, const string &path,
+                             const VCSolution &sol) {
+                           std::lock_guard<std::mutex> lock(mutex);
+                           assert(path == paths[idx]);
+                           assert(sol.size == sizes[idx] && sol.complete);
+                           assert(sol.lpbound <= sol.size);
+                           seen[idx] += 1;
+                         });
+  for (auto c : seen)
+    assert(c == 1);
+  assert(rep.nfailed == 1);
+  for (auto &s : rep.stages)
+    assert(s.items == paths.size() && s.nthreads == 2);
+  ostringstream os;
+  os << rep;
+  assert(os.str().find("kernel") != string::npos);
+  remove_files({"pipe_petersen.inp", "pipe_petersen.vc"});
+  return 0;
+}
+
+int test_cache(void) {
+  using KGR::CacheEntry;
+  using KGR::CacheKey;
+  using KGR::SolutionCache;
+  std::remove("test.kgcache");
+  SolutionCache cache;
+  assert(cache.open("test.kgcache") && cache.nkeys() == 0);
+  assert(!cache.open("petersen.inp") && !cache.is_open());
+  assert(cache.open("test.kgcache"));
+
+  // miss stores graph and content keys, second call is hit
+  VCWorkspace ws;
+  VCSolution sol, again;
+  bool hit = true;
+  assert(KGR::cached_solve_file(cache, "petersen.inp", ws, sol, &hit));
+  assert(!hit && sol.size == 6 && cache.nkeys() == 2);
+  assert(KGR::cached_solve_file(cache, "petersen.inp", ws, again, &hit));
+  assert(hit && again.cover == sol.cover && again.lpbound == sol.lpbound);
+  assert(!KGR::cached_solve_file(cache, "no_such_file.inp", ws, sol));
+
+  // repeated line: other bytes, same graph, so no solve
+  {
+    ifstream ifs("petersen.inp");
+    ofstream ofs("petersen_rep.inp", ofstream::out | ofstream::trunc);
+    ofs << ifs.rdbuf() << "V1 V2\n";
+  }
+  assert(KGR::cached_solve_file(cache, "petersen_rep.inp", ws, sol, &hit));
+  assert(hit && sol.size == 6 && cache.nkeys() == 3);
+
+  // record keeps LP classes and bounds, survives reopen
+  VCProblem p;
+  ifstream ifs("petersen.inp");
+  read_graph_from_stream(ifs, p);
+  ifs.close();
+  CacheEntry entry;
+  cache.close();
+  assert(!cache.find(KGR::graph_key(p), entry));
+  assert(cache.open("test.kgcache") && cache.nkeys() == 3);
+  assert(cache.find(KGR::graph_key(p), entry));
+  assert(entry.n == 10 && entry.solution.lpbound == 5);
+  assert(entry.lpclasses == vector<int>(10, 1) && is_cover(p, entry.solution));
+
+  // edge order, repeats and end order do not change graph key
+  VCProblem q = p;
+  std::reverse(q.edges.begin(), q.edges.end());
+  std::swap(q.edges[0].first, q.edges[0].second);
+  q.edges.push_back(q.edges[3]);
+  assert(KGR::graph_key(q) == KGR::graph_key(p));
+  q.add_isolated(1);
+  assert(!(KGR::graph_key(q) == KGR::graph_key(p)));
+
+  // labels do: reordered lines give other first-appearance labels
+  VCProblem ab, ba;
+  istringstream sab("a b\nb c\n"), sba("b c\na b\n");
+  read_graph_from_stream(sab, ab);
+  read_graph_from_stream(sba, ba);
+  assert(!(KGR::graph_key(ab) == KGR::graph_key(ba)));
+
+  // many keys: table is rebuilt, data grows, all found after reopen
+  CacheEntry small;
+  small.n = 3;
+  small.solution.size = 1;
+  small.solution.cover = {1};
+  for (uint64_t i = 0; i != 3000; ++i) {
+    small.solution.lpbound = i % 7;
+    assert(cache.insert(CacheKey{i * 7919, i}, small));
+  }
+  assert(!cache.insert(CacheKey{7919, 1}, small));
+  assert(cache.alias(CacheKey{7919, 1}, CacheKey{1, 1}));
+  cache.close();
+  assert(cache.open("test.kgcache") && cache.nkeys() == 3004);
+  for (uint64_t i = 0; i != 3000; ++i) {
+    assert(cache.find(CacheKey{i * 7919, i}, entry));
+    assert(entry.n == 3 && entry.solution.lpbound == int(i % 7));
+    assert(entry.solution.cover == vector<int>{1} && entry.lpclasses.empty());
+  }
+  assert(cache.find(CacheKey{1, 1}, entry) && entry.solution.lpbound == 1);
+  assert(cache.find(KGR::graph_key(p), entry) && entry.solution.size == 6);
+
+  // damaged record is miss: count past data, cover id out of range,
+  // offset out of file
+  std::remove("bad.kgcache");
+  SolutionCache bad;
+  assert(bad.open("bad.kgcache") && bad.insert(CacheKey{5, 5}, small));
+  KGR::MappedFile raw;
+  assert(raw.map("bad.kgcache", true));
+  uint64_t *slot = reinterpret_cast<uint64_t *>(raw.data() + 64);
+  while (slot[2] == 0)
+    slot += 3;
+  int32_t *rec = reinterpret_cast<int32_t *>(raw.data() + slot[2]);
+  assert(rec[5] == 1 && rec[8] == 1);
+  rec[5] = 1 << 30;
+  assert(!bad.find(CacheKey{5, 5}, entry));
+  rec[5] = 1;
+  rec[8] = 7;
+  assert(!bad.find(CacheKey{5, 5}, entry));
+  rec[8] = 2;
+  assert(bad.find(CacheKey{5, 5}, entry) && entry.solution.cover[0] == 2);
+  slot[2] = raw.size();
+  assert(!bad.find(CacheKey{5, 5}, entry));
+  raw.unmap();
+  bad.close();
+
+  // pipeline: second pass over same files is served from cache
+  KGR::PipelineConfig cfg;
+  cfg.out_dir = "-";
+  cfg.cache = &cache;
+  vector<string> paths{"petersen.inp", "chvatal.inp", "us.inp",
+                       "no_such_file.inp"};
+  vector<int> sizes{6, 7, 35, 0};
+  auto check = [&](size_t idx, const string &, const VCSolution &s) {
+    assert(s.size == sizes[idx]);
+  };
+  KGR::PipelineReport rep = KGR::vc_pipeline(paths, cfg, check);
+  assert(rep.nhits == 1 && rep.nfailed == 1);
+  rep = KGR::vc_pipeline(paths, cfg, check);
+  assert(rep.nhits == 3 && rep.nfailed == 1);
+  cache.close();
+  remove_files({"test.kgcache", "bad.kgcache", "petersen_rep.inp"});
+  return 0;
+}
+
+int test_canon(void) {
+  using KGR::CanonForm;
+  using KGR::SmallGraph;
+  Lcg rnd(777);
+  auto relabel = [&rnd](const SmallGraph &g) {
+    vector<int> to(g.n);
+    for (int i = 0; i != g.n; ++i)
+      to[i] = i;
+    for (int i = g.n - 1; i > 0; --i)
+      std::swap(to[i], to[rnd(i + 1)]);
+    SmallGraph h;
+    h.n = g.n;
+    for (int u = 0; u != g.n; ++u)
+      for (int v = 0; v != u; ++v)
+        if ((g.adj[u] >> v) & 1)
+          h.add_edge(to[u], to[v]);
+    return h;
+  };
+  auto cover_ok = [](const SmallGraph &g, uint32_t c) {
+    for (int v = 0; v != g.n; ++v)
+      if (!((c >> v) & 1) && (g.adj[v] & ~c) != 0)
+        return false;
+    return true;
+  };
+
+  SmallGraph petersen, chvatal;
+  petersen.n = 10;
+  for (auto &e : petersen_edges)
+    petersen.add_edge(e[0], e[1]);
+  chvatal.n = 12;
+  for (auto &e : chvatal_edges)
+    chvatal.add_edge(e[0], e[1]);
+
+  // relabeled copies have same form, perm maps form back to graph
+  CanonForm pf, qf, cf;
+  int perm[KGR::canon_max];
+  assert(KGR::canonical_form(petersen, pf, perm));
+  for (int rep = 0; rep != 20; ++rep) {
+    SmallGraph q = relabel(petersen);
+    assert(KGR::canonical_form(q, qf, perm) && qf == pf);
+    for (int i = 0; i != q.n; ++i)
+      for (int j = 0; j != q.n; ++j)
+        assert(((qf.rows[i] >> j) & 1) == ((q.adj[perm[i]] >> perm[j]) & 1));
+  }
+  assert(KGR::canonical_form(chvatal, cf, perm) && !(cf == pf));
+  SmallGraph pe = petersen;
+  pe.add_edge(0, 2);
+  assert(KGR::canonical_form(pe, qf, perm) && !(qf == pf));
+
+  // twins keep symmetric graphs cheap: K32 and K16,16
+  SmallGraph clique, bip;
+  clique.n = bip.n = 32;
+  for (int u = 0; u != 32; ++u)
+    for (int v = 0; v != u; ++v) {
+      clique.add_edge(u, v);
+      if ((u < 16) != (v < 16))
+        bip.add_edge(u, v);
+    }
+  assert(KGR::canonical_form(clique, qf, perm, 64));
+  assert(KGR::canonical_form(bip, qf, perm, 64));
+  assert(__builtin_popcount(KGR::small_min_cover(clique)) == 31);
+  assert(__builtin_popcount(KGR::small_min_cover(bip)) == 16);
+
+  // random graphs: forms of copies agree, covers against exhaustive search
+  for (int rep = 0; rep != 200; ++rep) {
+    SmallGraph g;
+    g.n = 1 + rnd(12);
+    int m = rnd(3 * g.n);
+    for (int i = 0; i != m; ++i) {
+      int u = rnd(g.n), v = rnd(g.n);
+      if (u != v)
+        g.add_edge(u, v);
+    }
+    VCProblem p;
+    p.add_isolated(g.n);
+    for (int u = 0; u != g.n; ++u)
+      for (int v = 0; v != u; ++v)
+        if ((g.adj[u] >> v) & 1)
+          p.add_link(u, v);
+    uint32_t c = KGR::small_min_cover(g);
+    assert(cover_ok(g, c) && __builtin_popcount(c) == cover_exhaustive(p));
+    assert(KGR::canonical_form(g, pf, perm));
+    assert(KGR::canonical_form(relabel(g), qf, perm) && qf == pf);
+  }
+
+  // memo: first copy is solved, others are lookups mapped to own labels
+  KGR::CoverMemo memo;
+  bool hit = true;
+  uint32_t c = memo.cover(petersen, &hit);
+  assert(!hit && __builtin_popcount(c) == 6 && cover_ok(petersen, c));
+  for (int rep = 0; rep != 10; ++rep) {
+    SmallGraph q = relabel(petersen);
+    c = memo.cover(q, &hit);
+    assert(hit && __builtin_popcount(c) == 6 && cover_ok(q, c));
+  }
+  assert(memo.size() == 1 && memo.hits() == 10 && memo.misses() == 1);
+
+  // workspace: kernel of 20 relabeled Petersen copies and one chvatal
+  memo.clear();
+  VCProblem many;
+  for (int rep = 0; rep != 21; ++rep) {
+    SmallGraph q = relabel(rep == 20 ? chvatal : petersen);
+    int base = many.n;
+    many.add_isolated(q.n);
+    for (int u = 0; u != q.n; ++u)
+      for (int v = 0; v != u; ++v)
+        if ((q.adj[u] >> v) & 1)
+          many.add_link(base + u, base + v);
+  }
+  VCWorkspace ws;
+  ws.set_memo(&memo);
+  VCSolution sol = ws.solve(many);
+  assert(is_cover(many, sol) && sol.size == 20 * 6 + 7);
+  assert(memo.size() == 2 && memo.hits() == 19);
+  assert(!ws.cover_within(many, 126, sol) && sol.complete);
+  assert(ws.cover_within(many, 127, sol) && is_cover(many, sol));
+  KGR::VCProof proof;
+  sol = ws.minimize(many, proof);
+  assert(sol.size == 127 && proof.lower <= 127);
+
+  // decision on GraphBuilder shares memo between calls
+  GraphBuilder<colorload, colorload> GNC;
+  ifstream ifs("petersen.inp");
+  read_graph_from_stream(ifs, GNC);
+  size_t hits = memo.hits();
+  auto any = [](VD) { return -1; };
+  assert(!vertex_cover_brute(GNC, 5, any, nullptr, &memo));
+  assert(vertex_cover_brute(GNC, 6, any, nullptr, &memo));
+  assert(memo.hits() == hits + 2);
+  assert(min_vertex_cover(GNC, proof, nullptr, &memo) == 6);
+  GNC.cleanup();
+  return 0;
+}
+
+int test_split(void) {
+  GraphBuilder<colorload, colorload> GNC;
+  ifstream ifs("us.inp");
+  read_graph_from_stream(ifs, GNC);
+  for (auto vd : GNC) {
+    vd->load.color = GNC.index(vd) % 3;
+    for (auto ed = vd->arcs; ed != GNC.last_edge(); ed = ed->next)
+      ed->load.color = GNC.index(ed->tip) % 2;
+  }
+
+  // same rows, same arc order and loads as Graph
+  Graph<colorload, colorload> G(GNC);
+  SplitGraph<colorload, colorload> SG(GNC);
+  assert(SG.nvertices() == G.nvertices() && SG.narcs() == G.narcs());
+  for (int v = 0; v != SG.nvertices(); ++v) {
+    auto sv = SG.vertex(v);
+    auto gv = G.vertex(v);
+    assert(sv->load.color == gv->load.color);
+    assert(SG.degree(sv) == G.degree(gv) && SG.original(sv) == v);
+    auto sa = sv->arcs;
+    for (auto ga = gv->arcs; ga != G.last_edge(); ga = ga->next) {
+      assert(SG.index(sa->tip) == G.index(ga->tip));
+      assert(sa->load.color == ga->load.color);
+      sa = sa->next;
+    }
+    assert(sa == SG.last_edge());
+  }
+
+  // topology arrays alone describe rows, loads are written through handles
+  const uint32_t *off = SG.layout().offsets(), *tips = SG.layout().tips();
+  assert(off[SG.nvertices()] == (uint32_t)SG.narcs());
+  auto first = SG.front()->arcs;
+  assert(tips[SG.arc(first)] == (uint32_t)SG.index(first->tip));
+  first->load.color = 7;
+  SG.front()->load.color = 5;
+  assert(SG.front()->arcs->load.color == 7 && SG.front()->load.color == 5);
+  assert(SG.layout().topology_bytes() ==
+         (SG.nvertices() + 1 + SG.narcs()) * sizeof(uint32_t));
+
+  // algorithms from KGAlg.hpp, same answers as on builder
+  using SVD = decltype(SG)::VertexDescriptor;
+  assert(!vertex_cover_brute(SG, 34, [](SVD) { return -1; }));
+  assert(vertex_cover_brute(SG, 35, [](SVD) { return -1; }));
+  GNC.cleanup();
+
+  add_bipart_fixture(GNC);
+  auto order = vector<int>(GNC.nvertices());
+  for (size_t i = 0; i != order.size(); ++i)
+    order[i] = order.size() - 1 - i;
+  SplitGraph<colorload, colorload> SB(GNC, order);
+  assert(SB.original(SB.front()) == GNC.nvertices() - 1);
+  assert(color_bipartite(SB) && hopcroft_karp(SB) == 6);
+  assert(matching_to_cover(SB) == 6);
+  GNC.cleanup();
+
+  // edge list and bulk: no edge loads stored
+  SplitGraph<colorload, noload> SN(4, {{0, 3}, {3, 0}, {1, 2}});
+  assert(SN.narcs() == 6 && SN.degree(SN.vertex(3)) == 2);
+  assert(SN.layout().load_bytes() == 4 * sizeof(colorload));
+  assert(color_bipartite(SN));
+  vector<pair<int, int>> edges{{0, 3}, {3, 0}, {1, 2}};
+  SplitGraph<colorload, noload> SK(4, edges.data(), edges.size(), 2);
+  assert(SK.narcs() == 4 && SK.degree(SK.vertex(3)) == 1);
+  assert(SK.get_edge(SK.vertex(3), SK.vertex(0)) != SK.last_edge());
+
+  // build code is Graph's: relabeled edge list comes with layout
+  SplitGraph<colorload, noload> SO(4, edges, {3, 2, 1, 0});
+  Graph<colorload, noload> GO(4, edges, {3, 2, 1, 0});
+  for (int v = 0; v != 4; ++v)
+    assert(SO.degree(SO.vertex(v)) == GO.degree(GO.vertex(v)) &&
+           SO.original(SO.vertex(v)) == 3 - v);
+  assert(std::equal(SO.layout().offsets(), SO.layout().offsets() + 5,
+                    vector<uint32_t>{0, 2, 3, 4, 6}.begin()));
   return 0;
 }
 
@@ -224,4 +1958,24 @@ int main(void) {
   test_bipart();
   test_vc();
   test_bst();
+  test_formats();
+  test_batch();
+  test_frozen();
+  test_order();
+  test_dense();
+  test_bounds();
+  test_dynamic();
+  test_stream();
+  test_mapped();
+  test_packed();
+  test_bulk();
+  test_index();
+  test_treedec();
+  test_static();
+  test_minimize();
+  test_budget();
+  test_pipeline();
+  test_cache();
+  test_canon();
+  test_split();
 }
@@ -18,16 +18,28 @@
 //
 // vertex_2approx -- find 2-approximation for vertex cover in general graph
 //
-// vertex_cover_brute -- brute force vertex cover
+// vertex_cover_brute -- exact vertex cover decision, pruned by bounds
 //
-// vertex_cover_trivial -- trivial solver (for max kernel degree = 2)
+// vertex_cover_treedec -- same decision, DP over tree decomposition
+//
+// min_vertex_cover -- minimum cover in one call, with optimality proof
+//
+// vertex_cover_trivial -- linear time solver (for max kernel degree = 2)
+//
+// Searches and matching take optional SolveBudget (see KGBudget.hpp) to be
+// stopped by deadline or cancellation. Exact searches also take optional
+// CoverMemo (see KGCanon.hpp): small kernel components repeated between
+// or within calls are covered by lookup.
 //
 //===----------------------------------------------------------------------===//
 
 #ifndef GRAPH_KALG_GUARD__
 #define GRAPH_KALG_GUARD__
 
+#include "KGCanon.hpp"
 #include "KGInc.hpp"
+#include "KGSolver.hpp"
+#include "KGTreeDec.hpp"
 
 // DFS-like coloring with additional stack, like Knuth alg7-B
 template <typename G> bool color_bipartite(G &g) {
@@ -68,55 +80,54 @@ template <typename G> bool color_bipartite(G &g) {
   return true;
 }
 
-template <typename G, typename VD>
-bool hk_bfs(G &g, vector<VD> &U, map<VD, VD> &PairU, map<VD, VD> &PairV,
-            map<VD, int> &Dist);
+template <typename G>
+bool hk_bfs(G &g, vector<int> &U, vector<int> &PairU, vector<int> &PairV,
+            vector<int> &Dist, KGR::SolveBudget *budget);
 
-template <typename G, typename VD>
-bool hk_dfs(G &g, vector<VD> &U, vector<VD> &V, map<VD, VD> &PairU,
-            map<VD, VD> &PairV, map<VD, int> &Dist, VD u);
+template <typename G>
+bool hk_dfs(G &g, vector<int> &PairU, vector<int> &PairV, vector<int> &Dist,
+            int u);
 
 // input is 0-1 colored bipartite graph
 // with colorable edges
-template <typename G> int hopcroft_karp(G &g) {
-  using VD = typename G::VertexDescriptor;
-
+// per-vertex state is in vectors by g.index(vd), nil is index n
+// budget is polled per BFS vertex and per augmenting DFS; when it stops,
+// matching found so far is colored and returned
+template <typename G>
+int hopcroft_karp(G &g, KGR::SolveBudget *budget = nullptr) {
   int matching = 0;
-  auto nil = g.last_vertex();
+  int nil = g.nvertices();
   auto enil = g.last_edge();
-  vector<VD> U, V;
-  map<VD, VD> PairU, PairV;
-  map<VD, int> Dist;
+  vector<int> U;
+  vector<int> PairU(nil + 1, nil), PairV(nil + 1, nil), Dist(nil + 1);
 
   for (auto vd : g)
-    if (vd->load.color == 0) {
-      U.push_back(vd);
-      PairU[vd] = nil;
-    } else {
-      V.push_back(vd);
-      PairV[vd] = nil;
-    }
+    if (vd->load.color == 0)
+      U.push_back(g.index(vd));
 
-  while (hk_bfs(g, U, PairU, PairV, Dist))
-    for (auto ud : U)
-      if (PairU[ud] == nil)
-        if (hk_dfs(g, U, V, PairU, PairV, Dist, ud))
+  while (hk_bfs(g, U, PairU, PairV, Dist, budget))
+    for (auto u : U) {
+      if (budget && budget->expired())
+        break;
+      if (PairU[u] == nil)
+        if (hk_dfs(g, PairU, PairV, Dist, u))
           matching = matching + 1;
+    }
 
   // after pairing complete color edges
-  for (auto vdps : PairU) {
-    VD u = vdps.first;
-    VD v = vdps.second;
+  for (auto u : U) {
+    int v = PairU[u];
 
     // unmatched vertex
-    if ((v == nil) || (u == nil))
+    if (v == nil)
       continue;
-    assert(PairU[u] == v);
     assert(PairV[v] == u);
-    auto e = g.get_edge(u, v);
+    auto ud = g.vertex(u);
+    auto vd = g.vertex(v);
+    auto e = g.get_edge(ud, vd);
     assert(e != enil);
     e->load.color = 1;
-    auto ev = g.get_edge(v, u);
+    auto ev = g.get_edge(vd, ud);
     assert(ev != enil);
     ev->load.color = 1;
   }
@@ -124,59 +135,84 @@ template <typename G> int hopcroft_karp(G &g) {
   return matching;
 }
 
-template <typename G, typename VD>
-bool hk_bfs(G &g, vector<VD> &U, map<VD, VD> &PairU, map<VD, VD> &PairV,
-            map<VD, int> &Dist) {
-  auto nil = g.last_vertex();
+template <typename G>
+bool hk_bfs(G &g, vector<int> &U, vector<int> &PairU, vector<int> &PairV,
+            vector<int> &Dist, KGR::SolveBudget *budget) {
+  int nil = g.nvertices();
   auto enil = g.last_edge();
   int inf = std::numeric_limits<int>::max();
-  list<VD> Q;
+  vector<int> Q;
 
-  for (auto ud : U) {
-    if (PairU[ud] == nil) {
-      Dist[ud] = 0;
-      Q.push_back(ud);
+  for (auto u : U) {
+    if (PairU[u] == nil) {
+      Dist[u] = 0;
+      Q.push_back(u);
     } else
-      Dist[ud] = inf;
+      Dist[u] = inf;
   }
 
   Dist[nil] = inf;
 
-  while (!Q.empty()) {
-    auto u = Q.front();
-    Q.pop_front();
+  // nil is never queued: nothing to scan from it
+  for (size_t qpos = 0; qpos != Q.size(); ++qpos) {
+    if (budget && budget->expired())
+      return false;
+    int u = Q[qpos];
     if (Dist[u] < Dist[nil])
-      for (auto e = u->arcs; e != enil; e = e->next) {
-        VD v = e->tip;
+      for (auto e = g.vertex(u)->arcs; e != enil; e = e->next) {
+        int v = g.index(e->tip);
         if (Dist[PairV[v]] == inf) {
           Dist[PairV[v]] = Dist[u] + 1;
-          Q.push_back(PairV[v]);
+          if (PairV[v] != nil)
+            Q.push_back(PairV[v]);
         }
       }
   }
   return (Dist[nil] != inf);
 }
 
-template <typename G, typename VD>
-bool hk_dfs(G &g, vector<VD> &U, vector<VD> &V, map<VD, VD> &PairU,
-            map<VD, VD> &PairV, map<VD, int> &Dist, VD u) {
-  auto nil = g.last_vertex();
+// iterative: path holds left vertices of current augmenting path with
+// arc being tried from each, so long paths (large or mapped graphs) do
+// not grow call stack
+template <typename G>
+bool hk_dfs(G &g, vector<int> &PairU, vector<int> &PairV, vector<int> &Dist,
+            int root) {
+  int nil = g.nvertices();
   auto enil = g.last_edge();
   int inf = std::numeric_limits<int>::max();
-  if (u == nil)
-    return true;
-  for (auto e = u->arcs; e != enil; e = e->next) {
-    VD v = e->tip;
-    if (Dist[PairV[v]] == Dist[u] + 1)
-      if (hk_dfs(g, U, V, PairU, PairV, Dist, PairV[v])) {
-        PairV[v] = u;
-        PairU[u] = v;
+  vector<pair<int, decltype(enil)>> path;
+  path.emplace_back(root, g.vertex(root)->arcs);
+  while (!path.empty()) {
+    int u = path.back().first;
+    int next = -1;
+    for (auto &e = path.back().second; e != enil; e = e->next) {
+      int v = g.index(e->tip);
+      if (Dist[PairV[v]] != Dist[u] + 1)
+        continue;
+      if (PairV[v] == nil) {
         // There is temptation to color edges here.
         // This idea is bad. Mapping can change several times.
+        for (auto &p : path) {
+          int w = g.index(p.second->tip);
+          PairV[w] = p.first;
+          PairU[p.first] = w;
+        }
         return true;
       }
+      next = PairV[v];
+      break;
+    }
+    if (next != -1) {
+      path.emplace_back(next, g.vertex(next)->arcs);
+      continue;
+    }
+
+    // dead end: u is not tried again in this phase, parent moves on
+    Dist[u] = inf;
+    path.pop_back();
+    if (!path.empty())
+      path.back().second = path.back().second->next;
   }
-  Dist[u] = inf;
   return false;
 }
 
@@ -277,12 +313,17 @@ template <typename G> void vertex_2approx(G &g) {
 }
 
 // all (k out of n) subsets without repetitions
-template <typename C> bool all_subsets(int n, int k, C callback) {
+// false also if budget stopped enumeration
+template <typename C>
+bool all_subsets(int n, int k, C callback,
+                 KGR::SolveBudget *budget = nullptr) {
   int idx;
   vector<int> bitmask(k, 1);
   bitmask.resize(n, 0);
 
   do {
+    if (budget && budget->expired())
+      return false;
     bool res = callback(bitmask);
     if (res)
       return true;
@@ -291,63 +332,164 @@ template <typename C> bool all_subsets(int n, int k, C callback) {
   return false;
 }
 
-// naive approach (good for some tests)
+// exact decision: is there cover with at most k undecided vertices
 // callback to mark kernel
 // return 0 means always-no
 // return 1 means always-yes
-// return -1 means need to brute
-template <typename G, typename C> bool vertex_cover_brute(G &g, int k, C cbf) {
-  using VD = typename G::VertexDescriptor;
+// return -1 means need to search
+// undecided neighbors of always-no vertices are forced, rest goes to
+// backend solve(problem, limit, solution), true if cover fits limit
+template <typename G, typename C, typename S>
+bool vertex_cover_with(G &g, int k, C cbf, S solve) {
   assert(k > 0);
-  int n = 0;
-  int nsel = 0;
-  map<VD, int> indexes;
+  int n = g.nvertices();
+  int forced = 0;
+  vector<int> marks(n), indexes(n);
   auto enil = g.last_edge();
   for (auto vd : g)
-    if (cbf(vd) == -1)
-      indexes[vd] = n++;
-
-  nsel = n;
-  vector<int> gmarks(nsel, 0);
+    marks[g.index(vd)] = cbf(vd);
 
+  // 2 is for forced ones
   for (auto vd : g) {
-    int s = cbf(vd);
-    if (s != -1) {
-      gmarks.push_back(s);
-      indexes[vd] = n++;
+    if (marks[g.index(vd)] != 0)
+      continue;
+    for (auto e = vd->arcs; e != enil; e = e->next) {
+      int &m = marks[g.index(e->tip)];
+      if (m == 0)
+        return false;
+      if (m == -1) {
+        m = 2;
+        forced += 1;
+      }
     }
   }
+  if (forced > k)
+    return false;
 
-  assert(n == g.nvertices());
-  assert(n == gmarks.size());
+  KGR::VCProblem p;
+  for (int i = 0; i != n; ++i)
+    if (marks[i] == -1)
+      indexes[i] = p.n++;
+  for (auto vd : g) {
+    int fst = g.index(vd);
+    if (marks[fst] != -1)
+      continue;
+    for (auto e = vd->arcs; e != enil; e = e->next) {
+      int snd = g.index(e->tip);
+      if (marks[snd] == -1 && fst < snd)
+        p.add_link(indexes[fst], indexes[snd]);
+    }
+  }
 
-  // all k-subsets from n
-  bool res = all_subsets(nsel, k, [&](vector<int> &marks) {
-    assert(marks.size() == nsel);
+  KGR::VCSolution sol;
+  if (!solve(p, k - forced, sol))
+    return false;
 
-    for (int i = 0; i < nsel; ++i)
-      gmarks[i] = marks[i];
+  // TODO: one more callback for final color?
+  vector<char> incover(p.n, 0);
+  for (auto v : sol.cover)
+    incover[v] = 1;
+  for (auto vd : g) {
+    int m = marks[g.index(vd)];
+    bool in = (m == -1) ? incover[indexes[g.index(vd)]] : (m != 0);
+    vd->load.color = in ? 2 : 0;
+  }
+  return true;
+}
 
-    for (auto vd : g) {
-      if (gmarks[indexes[vd]])
-        continue;
-      for (auto e = vd->arcs; e != enil; e = e->next)
-        if (!gmarks[indexes[e->tip]])
-          return false;
+// optimization: minimum cover colored 2 (rest 0), returns its size
+// no k-loop over vertex_cover_brute: VCWorkspace::minimize kernelizes
+// once, searches between 2-approximation and LP / clique bound; proof
+// tells which bound closed the gap
+// budget stops search with best known cover, see VCSolution::complete
+template <typename G>
+int min_vertex_cover(G &g, KGR::VCProof &proof,
+                     KGR::SolveBudget *budget = nullptr,
+                     KGR::CoverMemo *memo = nullptr) {
+  KGR::VCProblem p;
+  auto enil = g.last_edge();
+  p.add_isolated(g.nvertices());
+  for (auto vd : g) {
+    int fst = g.index(vd);
+    for (auto e = vd->arcs; e != enil; e = e->next) {
+      int snd = g.index(e->tip);
+      if (fst < snd)
+        p.add_link(fst, snd);
     }
+  }
 
-    return true;
-  });
+  KGR::VCWorkspace ws;
+  ws.set_budget(budget);
+  ws.set_memo(memo);
+  KGR::VCSolution sol = ws.minimize(p, proof);
+  vector<char> incover(p.n, 0);
+  for (auto v : sol.cover)
+    incover[v] = 1;
+  for (auto vd : g)
+    vd->load.color = incover[g.index(vd)] ? 2 : 0;
+  return sol.size;
+}
 
-  // TODO: one more callback for final color?
-  if (res) {
-    for (auto vd : g)
-      if (gmarks[indexes[vd]])
-        vd->load.color = 2;
-      else
-        vd->load.color = 0;
-  }
+// search backend is VCWorkspace::cover_within, which prunes by lower bounds
+// false also if budget stopped search, see budget->stopped()
+template <typename G, typename C>
+bool vertex_cover_brute(G &g, int k, C cbf,
+                        KGR::SolveBudget *budget = nullptr,
+                        KGR::CoverMemo *memo = nullptr) {
+  return vertex_cover_with(
+      g, k, cbf, [budget, memo](const KGR::VCProblem &p, int limit,
+                                KGR::VCSolution &sol) {
+        KGR::VCWorkspace ws;
+        ws.set_budget(budget);
+        ws.set_memo(memo);
+        return ws.cover_within(p, limit, sol);
+      });
+}
+
+// same decision by dynamic program over tree decomposition of undecided
+// vertices, time does not depend on k; falls back to cover_within if
+// heuristic width exceeds maxwidth
+// budget is polled by fallback only, program itself is O(2^w n)
+template <typename G, typename C>
+bool vertex_cover_treedec(G &g, int k, C cbf, int maxwidth = 16,
+                          KGR::SolveBudget *budget = nullptr) {
+  return vertex_cover_with(g, k, cbf,
+                           [maxwidth, budget](const KGR::VCProblem &p,
+                                              int limit,
+                                              KGR::VCSolution &sol) {
+                             if (KGR::vc_treedec(p, sol, maxwidth))
+                               return sol.size <= limit;
+                             KGR::VCWorkspace ws;
+                             ws.set_budget(budget);
+                             return ws.cover_within(p, limit, sol);
+                           });
+}
 
+// walks one path (from end) or cycle (from any vertex) of unmarked
+// vertices, nbs has two slots per vertex, -1 for none
+// path gets 0, 1, 0, ... from its end, cycle same with 1 on last vertex
+// returns number of vertices marked 1
+template <typename VD, typename CM>
+int trivial_walk(const vector<VD> &verts, const vector<int> &nbs, int start,
+                 CM cmf) {
+  int res = 0, prev = -1, cur = start, c = 0;
+  bool cycle = (nbs[2 * start + 1] != -1);
+  // cycle goes towards smaller neighbor first
+  if (cycle && nbs[2 * start + 1] < nbs[2 * start])
+    prev = nbs[2 * start];
+
+  for (;;) {
+    int next = (nbs[2 * cur] != prev) ? nbs[2 * cur] : nbs[2 * cur + 1];
+    if (cycle && next == start)
+      c = 1;
+    cmf(verts[cur], c);
+    res += c;
+    if (next == -1 || next == start)
+      break;
+    prev = cur;
+    cur = next;
+    c ^= 1;
+  }
   return res;
 }
 
@@ -356,35 +498,71 @@ template <typename G, typename C> bool vertex_cover_brute(G &g, int k, C cbf) {
 // return 1 means marked-yes
 // return -1 means not marked yet
 // callback cmf to mark vertex as yes (1) or no (0)
+// unmarked vertices form paths and cycles, each one is walked once and
+// covered optimally, O(V + E); components are split between nthreads,
+// cmf is then called concurrently for distinct vertices
 template <typename G, typename CI, typename CM>
-int vertex_cover_trivial(G &g, CI cbf, CM cmf) {
+int vertex_cover_trivial(G &g, CI cbf, CM cmf, int nthreads = 1) {
   using VD = typename G::VertexDescriptor;
-  int res = 0;
-  auto nil = g.last_vertex();
   auto enil = g.last_edge();
+  vector<VD> verts;
+  vector<int> local(g.nvertices(), -1), nbs;
 
-  for (;;) {
-    VD pokevd = nil;
-    for (auto vd : g)
-      if (cbf(vd) == -1) {
-        pokevd = vd;
-        cmf(vd, 0);
-        int check_deg = 0;
-
-        for (auto e = vd->arcs; e != enil; e = e->next)
-          if (cbf(e->tip) == -1) {
-            check_deg += 1;
-            assert(check_deg < 3 &&
-                   "Trivial method works only for max. degree 2");
-            res += 1;
-            cmf(e->tip, 1);
-          }
-      }
+  for (auto vd : g)
+    if (cbf(vd) == -1) {
+      local[g.index(vd)] = verts.size();
+      verts.push_back(vd);
+    }
 
-    if (pokevd == nil)
-      break;
+  // two neighbor slots per unmarked vertex, parallel edges merged
+  nbs.assign(2 * verts.size(), -1);
+  for (size_t i = 0; i != verts.size(); ++i) {
+    int check_deg = 0;
+    for (auto e = verts[i]->arcs; e != enil; e = e->next) {
+      int j = local[g.index(e->tip)];
+      if (j == -1 || j == (int)i || (check_deg == 1 && nbs[2 * i] == j))
+        continue;
+      assert(check_deg < 2 && "Trivial method works only for max. degree 2");
+      nbs[2 * i + check_deg] = j;
+      check_deg += 1;
+    }
   }
 
+  // component starts: paths from ends, then what is left are cycles
+  vector<int> starts;
+  vector<char> seen(verts.size(), 0);
+  auto claim = [&](int s) {
+    starts.push_back(s);
+    for (int prev = -1, cur = s; cur != -1 && !seen[cur];) {
+      seen[cur] = 1;
+      int next = (nbs[2 * cur] != prev) ? nbs[2 * cur] : nbs[2 * cur + 1];
+      prev = cur;
+      cur = next;
+    }
+  };
+  for (size_t i = 0; i != verts.size(); ++i)
+    if (!seen[i] && nbs[2 * i + 1] == -1)
+      claim(i);
+  for (size_t i = 0; i != verts.size(); ++i)
+    if (!seen[i])
+      claim(i);
+
+  nthreads = std::max(1, std::min<int>(nthreads, starts.size()));
+  vector<int> sums(nthreads, 0);
+  auto worker = [&](int t) {
+    for (size_t c = t; c < starts.size(); c += nthreads)
+      sums[t] += trivial_walk(verts, nbs, starts[c], cmf);
+  };
+  vector<std::thread> threads;
+  for (int t = 1; t < nthreads; ++t)
+    threads.emplace_back(worker, t);
+  worker(0);
+  for (auto &t : threads)
+    t.join();
+
+  int res = 0;
+  for (auto s : sums)
+    res += s;
   return res;
 }
 
@@ -0,0 +1,67 @@
+//===-- KGBatch.cpp -- batch vertex cover solving supplement --------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGBatch.hpp"
+
+namespace KGR {
+
+VCPool::VCPool(int nthreads) {
+  nthreads = thread_count(nthreads);
+  for (int t = 0; t != nthreads; ++t)
+    workers_.emplace_back([this] { worker(); });
+}
+
+VCPool::~VCPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &w : workers_)
+    w.join();
+}
+
+void VCPool::worker() {
+  VCWorkspace ws;
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+      if (jobs_.empty())
+        return;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job(ws);
+  }
+}
+
+void VCPool::run(Job job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+  }
+  cv_.notify_one();
+}
+
+std::future<VCSolution> VCPool::submit(VCProblem problem) {
+  auto result = std::make_shared<std::promise<VCSolution>>();
+  auto pp = std::make_shared<VCProblem>(std::move(problem));
+  run([result, pp](VCWorkspace &ws) { result->set_value(ws.solve(*pp)); });
+  return result->get_future();
+}
+
+vector<VCSolution> vc_solve_batch(VCPool &pool,
+                                  const vector<VCProblem> &problems) {
+  vector<VCSolution> res(problems.size());
+  vc_solve_batch(pool, problems, [&res](size_t idx, VCSolution &sol) {
+    res[idx] = std::move(sol);
+  });
+  return res;
+}
+}
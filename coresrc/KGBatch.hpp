@@ -0,0 +1,85 @@
+//===-- KGBatch.hpp -- batch vertex cover solving on thread pool ----------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// VCPool -- worker threads, every worker owns VCWorkspace for its lifetime
+//
+// vc_solve_batch -- solves many problems on pool, results to callback
+//                   or to vector in input order
+//
+// Workspace is never shared, so jobs need no locking except job queue.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KBATCH_GUARD__
+#define GRAPH_KBATCH_GUARD__
+
+#include "KGSolver.hpp"
+
+namespace KGR {
+
+class VCPool final {
+  using Job = std::function<void(VCWorkspace &)>;
+  vector<std::thread> workers_;
+  std::deque<Job> jobs_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  void worker();
+
+public:
+  // nthreads == 0 means hardware concurrency
+  explicit VCPool(int nthreads = 0);
+  VCPool(const VCPool &) = delete;
+  VCPool &operator=(const VCPool &) = delete;
+  ~VCPool();
+
+  int nthreads() const { return workers_.size(); }
+
+  // runs job(ws) on some worker with its own workspace
+  void run(Job job);
+
+  // single problem, result through future
+  std::future<VCSolution> submit(VCProblem problem);
+
+  // single problem, result through callback(solution) on worker thread
+  template <typename C> void submit(VCProblem problem, C callback) {
+    auto pp = std::make_shared<VCProblem>(std::move(problem));
+    run([pp, callback](VCWorkspace &ws) mutable { callback(ws.solve(*pp)); });
+  }
+};
+
+// callback(idx, solution) is called from worker threads, possibly
+// concurrently, returns when all problems are solved
+// problems are pulled from shared counter, so there is no per-problem
+// job in queue: every worker takes next problem as soon as it is free
+template <typename C>
+void vc_solve_batch(VCPool &pool, const vector<VCProblem> &problems,
+                    C callback) {
+  std::atomic<size_t> next{0};
+  vector<std::future<void>> done;
+  for (int t = 0; t != pool.nthreads(); ++t) {
+    auto finished = std::make_shared<std::promise<void>>();
+    done.push_back(finished->get_future());
+    pool.run([&, finished](VCWorkspace &ws) {
+      for (size_t idx = next++; idx < problems.size(); idx = next++) {
+        VCSolution sol = ws.solve(problems[idx]);
+        callback(idx, sol);
+      }
+      finished->set_value();
+    });
+  }
+  for (auto &f : done)
+    f.wait();
+}
+
+vector<VCSolution> vc_solve_batch(VCPool &pool,
+                                  const vector<VCProblem> &problems);
+}
+
+#endif
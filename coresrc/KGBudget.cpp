@@ -0,0 +1,27 @@
+//===-- KGBudget.cpp -- time budget and cancellation supplement -----------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGBudget.hpp"
+
+namespace KGR {
+
+constexpr uint64_t SolveBudget::check_every;
+
+// slow path of expired(), one clock read for deadline and report
+bool SolveBudget::poll() {
+  if (!has_deadline_ && !progress_)
+    return stopped();
+  auto now = clock::now();
+  if (has_deadline_ && now >= deadline_)
+    cancel();
+  if (progress_ && now >= next_report_) {
+    next_report_ = now + period_;
+    progress_(state_);
+  }
+  return stopped();
+}
+}
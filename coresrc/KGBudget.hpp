@@ -0,0 +1,91 @@
+//===-- KGBudget.hpp -- time budget and cancellation for solvers ----------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// SolveBudget -- cooperative stop: cancel flag, deadline and periodic
+//                progress callback, polled by solvers in their hot loops
+//
+// Solver calls expired() once per unit of work (search node, BFS vertex,
+// DFS start, subset). Usual call is increment, mask test and relaxed load
+// of cancel flag; clock is read and progress reported on every
+// check_every-th call only. Once expired, budget stays expired.
+//
+// Solvers stopped by budget return what they have: best cover found so
+// far (always a cover) and proven lower bound, see VCProof and
+// VCSolution::complete in KGSolver.hpp.
+//
+// One solver thread polls budget, cancel() is safe from any thread.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KBUDGET_GUARD__
+#define GRAPH_KBUDGET_GUARD__
+
+#include "KGInc.hpp"
+
+#include <chrono>
+
+namespace KGR {
+
+struct VCProgress {
+  int lower = 0;       // proven lower bound, 0 if none yet
+  int upper = -1;      // best cover found so far, -1 if none yet
+  uint64_t checks = 0; // calls of expired() so far
+};
+
+class SolveBudget final {
+public:
+  using clock = std::chrono::steady_clock;
+  using callback = std::function<void(const VCProgress &)>;
+  static constexpr uint64_t check_every = 1024; // power of two
+
+private:
+  std::atomic<bool> stop_{false};
+  bool has_deadline_ = false;
+  clock::time_point deadline_;
+  callback progress_;
+  clock::duration period_{0};
+  clock::time_point next_report_;
+  VCProgress state_;
+
+  bool poll();
+
+public:
+  // any thread, solver stops at its next check
+  void cancel() { stop_.store(true, std::memory_order_relaxed); }
+
+  void set_deadline(clock::time_point deadline) {
+    has_deadline_ = true;
+    deadline_ = deadline;
+  }
+  void set_timeout(clock::duration timeout) {
+    set_deadline(clock::now() + timeout);
+  }
+
+  // f is called from solver thread, at most once per period
+  void on_progress(callback f, clock::duration period) {
+    progress_ = std::move(f);
+    period_ = period;
+    next_report_ = clock::now() + period;
+  }
+
+  // hot loops: true means stop now
+  bool expired() {
+    if ((++state_.checks & (check_every - 1)) != 0)
+      return stop_.load(std::memory_order_relaxed);
+    return poll();
+  }
+
+  bool stopped() const { return stop_.load(std::memory_order_relaxed); }
+
+  // solvers keep bounds for progress reports
+  void set_lower(int lower) { state_.lower = lower; }
+  void set_upper(int upper) { state_.upper = upper; }
+  const VCProgress &progress() const { return state_; }
+};
+}
+
+#endif
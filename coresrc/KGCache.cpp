@@ -0,0 +1,372 @@
+//===-- KGCache.cpp -- persistent solution cache supplement ---------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace KGR {
+
+static const char cache_magic[8] = {'K', 'G', 'C', 'A', 'C', 'H', '1', '\0'};
+
+struct CacheHeader {
+  char magic[8];
+  uint64_t nslots, nused, data_end;
+};
+
+struct CacheSlot {
+  uint64_t h1, h2, offset;
+};
+
+struct CacheRecord {
+  int32_t n, size, lpbound, nkernel, complete, ncover, nclasses, pad;
+};
+
+// slots start at fixed offset, data right after them
+static const size_t slots_at = 64;
+static const size_t initial_slots = 1024;
+static const size_t initial_data = 1 << 16;
+
+static_assert(sizeof(CacheHeader) <= slots_at, "Header overlaps slots");
+
+static CacheHeader *header_of(const MappedFile &f) {
+  return reinterpret_cast<CacheHeader *>(f.data());
+}
+
+static CacheSlot *slots_of(const MappedFile &f) {
+  return reinterpret_cast<CacheSlot *>(f.data() + slots_at);
+}
+
+static size_t record_bytes(int ncover, int nclasses) {
+  size_t sz = sizeof(CacheRecord) + size_t(ncover) * sizeof(int32_t) +
+              size_t(nclasses);
+  return (sz + 7) & ~size_t(7);
+}
+
+// first data byte, right after slots
+static uint64_t data_begin_of(const MappedFile &f) {
+  return slots_at + header_of(f)->nslots * sizeof(CacheSlot);
+}
+
+// record at offset, checked against data region: counts shall fit, cover
+// ids and classes shall be in range; false leaves entry untouched
+static bool read_record(const MappedFile &f, uint64_t offset,
+                        CacheEntry &entry) {
+  uint64_t begin = data_begin_of(f), end = header_of(f)->data_end;
+  if (offset < begin || offset > end || end - offset < sizeof(CacheRecord))
+    return false;
+  const char *at = f.data() + offset;
+  CacheRecord rec;
+  std::memcpy(&rec, at, sizeof(rec));
+  if (rec.n < 0 || rec.ncover < 0 || rec.ncover > rec.n ||
+      rec.nclasses < 0 || rec.nclasses > rec.n ||
+      record_bytes(rec.ncover, rec.nclasses) > end - offset)
+    return false;
+  at += sizeof(rec);
+
+  VCSolution sol;
+  sol.size = rec.size;
+  sol.lpbound = rec.lpbound;
+  sol.nkernel = rec.nkernel;
+  sol.complete = rec.complete;
+  sol.cover.resize(rec.ncover);
+  std::memcpy(sol.cover.data(), at, rec.ncover * sizeof(int32_t));
+  at += rec.ncover * sizeof(int32_t);
+  for (auto v : sol.cover)
+    if (v < 0 || v >= rec.n)
+      return false;
+  vector<int> classes(at, at + rec.nclasses);
+  for (auto c : classes)
+    if (c < 0 || c > 2)
+      return false;
+
+  entry.n = rec.n;
+  entry.solution = std::move(sol);
+  entry.lpclasses = std::move(classes);
+  return true;
+}
+
+// splitmix64 finalizer
+static uint64_t mix64(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+void KeyHasher::add(uint64_t word) {
+  h1_ = mix64(h1_ ^ word);
+  h2_ = (h2_ + word) * 0xff51afd7ed558ccdull;
+  h2_ ^= h2_ >> 32;
+}
+
+// eight bytes per word, tail zero padded, length last
+void KeyHasher::add_bytes(const char *data, size_t size) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    add(word);
+  }
+  if (i != size) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, size - i);
+    add(word);
+  }
+  add(size);
+}
+
+CacheKey KeyHasher::key() const {
+  CacheKey k;
+  k.h1 = mix64(h1_);
+  k.h2 = mix64(h2_ ^ 0x5851f42d4c957f2dull);
+  return k;
+}
+
+CacheKey graph_key(const VCProblem &p) {
+  vector<uint64_t> words;
+  words.reserve(p.edges.size());
+  for (auto e : p.edges) {
+    uint64_t u = std::min(e.first, e.second), v = std::max(e.first, e.second);
+    words.push_back((u << 32) | v);
+  }
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+  KeyHasher h;
+  h.add(p.n);
+  h.add(words.size());
+  for (auto w : words)
+    h.add(w);
+  return h.key();
+}
+
+CacheKey content_key(const char *data, size_t size) {
+  KeyHasher h;
+  h.add_bytes(data, size);
+  return h.key();
+}
+
+bool SolutionCache::create(size_t nslots) {
+  size_t data_begin = slots_at + nslots * sizeof(CacheSlot);
+  if (!MappedFile::create(path_.c_str(), data_begin + initial_data) ||
+      !file_.map(path_.c_str(), true))
+    return false;
+  auto *hdr = header_of(file_);
+  std::memcpy(hdr->magic, cache_magic, sizeof(cache_magic));
+  hdr->nslots = nslots;
+  hdr->nused = 0;
+  hdr->data_end = data_begin;
+  return true;
+}
+
+bool SolutionCache::open(const string &path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  file_.unmap();
+  path_ = path;
+  if (!file_.map(path_.c_str(), true))
+    return access(path_.c_str(), F_OK) != 0 && create(initial_slots);
+  auto *hdr = header_of(file_);
+  if (file_.size() < slots_at ||
+      std::memcmp(hdr->magic, cache_magic, sizeof(cache_magic)) != 0 ||
+      hdr->nslots == 0 || (hdr->nslots & (hdr->nslots - 1)) != 0 ||
+      hdr->nslots > file_.size() / sizeof(CacheSlot) ||
+      data_begin_of(file_) > hdr->data_end || hdr->data_end > file_.size()) {
+    file_.unmap();
+    return false;
+  }
+  return true;
+}
+
+void SolutionCache::close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  file_.unmap();
+}
+
+// slot of key or first empty slot after it, table is never full
+size_t SolutionCache::probe(CacheKey key) const {
+  size_t mask = header_of(file_)->nslots - 1;
+  const CacheSlot *slots = slots_of(file_);
+  for (size_t i = key.h1 & mask;; i = (i + 1) & mask)
+    if (slots[i].offset == 0 ||
+        (slots[i].h1 == key.h1 && slots[i].h2 == key.h2))
+      return i;
+}
+
+// file doubles, mapping moves; old mapping stays valid while file only
+// grows, so it is kept until new one is made
+bool SolutionCache::grow_data(size_t need) {
+  size_t want = header_of(file_)->data_end + need;
+  if (want <= file_.size())
+    return true;
+  size_t size = std::max(want, 2 * file_.size());
+  MappedFile nf;
+  if (!MappedFile::resize(path_.c_str(), size) || !nf.map(path_.c_str(), true))
+    return false;
+  file_ = std::move(nf);
+  return true;
+}
+
+// new file with twice the slots, data copied, offsets shifted, then
+// renamed over old one; on failure temporary file is removed
+bool SolutionCache::rehash() {
+  auto *hdr = header_of(file_);
+  size_t nslots = 2 * hdr->nslots;
+  size_t old_begin = data_begin_of(file_);
+  size_t new_begin = slots_at + nslots * sizeof(CacheSlot);
+  size_t data_size = hdr->data_end - old_begin;
+  string tmp = path_ + ".tmp";
+  MappedFile nf;
+  if (!MappedFile::create(tmp.c_str(), new_begin + data_size + initial_data) ||
+      !nf.map(tmp.c_str(), true)) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+
+  auto *nhdr = header_of(nf);
+  std::memcpy(nhdr->magic, cache_magic, sizeof(cache_magic));
+  nhdr->nslots = nslots;
+  nhdr->nused = hdr->nused;
+  nhdr->data_end = new_begin + data_size;
+  std::memcpy(nf.data() + new_begin, file_.data() + old_begin, data_size);
+  const CacheSlot *from = slots_of(file_);
+  CacheSlot *to = slots_of(nf);
+  for (size_t i = 0; i != hdr->nslots; ++i) {
+    CacheSlot s = from[i];
+    if (s.offset == 0)
+      continue;
+    s.offset += new_begin - old_begin;
+    size_t j = s.h1 & (nslots - 1);
+    while (to[j].offset != 0)
+      j = (j + 1) & (nslots - 1);
+    to[j] = s;
+  }
+  nf.flush();
+  if (std::rename(tmp.c_str(), path_.c_str()) != 0) {
+    nf.unmap();
+    std::remove(tmp.c_str());
+    return false;
+  }
+  file_ = std::move(nf);
+  return true;
+}
+
+// record is written past data_end, end is where it stops; it is counted
+// only when caller moves data_end, so failure leaves no orphan record
+uint64_t SolutionCache::append(const CacheEntry &entry, uint64_t &end) {
+  const VCSolution &sol = entry.solution;
+  int ncover = sol.cover.size(), nclasses = entry.lpclasses.size();
+  size_t bytes = record_bytes(ncover, nclasses);
+  if (!grow_data(bytes))
+    return 0;
+  auto *hdr = header_of(file_);
+  uint64_t offset = hdr->data_end;
+  char *at = file_.data() + offset;
+  CacheRecord rec{entry.n, sol.size, sol.lpbound, sol.nkernel,
+                  sol.complete, ncover, nclasses, 0};
+  std::memcpy(at, &rec, sizeof(rec));
+  at += sizeof(rec);
+  for (auto v : sol.cover) {
+    int32_t x = v;
+    std::memcpy(at, &x, sizeof(x));
+    at += sizeof(x);
+  }
+  for (auto c : entry.lpclasses)
+    *at++ = static_cast<char>(c);
+  end = offset + bytes;
+  return offset;
+}
+
+// at most half of slots used, so probing stays short; rebuilt table
+// moves data, so offsets taken before are stale
+bool SolutionCache::reserve_slot() {
+  auto *hdr = header_of(file_);
+  return 2 * (hdr->nused + 1) <= hdr->nslots || rehash();
+}
+
+// slot shall be reserved
+bool SolutionCache::link(CacheKey key, uint64_t offset) {
+  size_t i = probe(key);
+  CacheSlot *slot = slots_of(file_) + i;
+  if (slot->offset != 0)
+    return false;
+  *slot = CacheSlot{key.h1, key.h2, offset};
+  header_of(file_)->nused += 1;
+  return true;
+}
+
+bool SolutionCache::find(CacheKey key, CacheEntry &entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!is_open())
+    return false;
+  const CacheSlot &slot = slots_of(file_)[probe(key)];
+  // damaged record is miss, as if key was never stored
+  return slot.offset != 0 && read_record(file_, slot.offset, entry);
+}
+
+bool SolutionCache::insert(CacheKey key, const CacheEntry &entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!is_open() || slots_of(file_)[probe(key)].offset != 0 ||
+      !reserve_slot())
+    return false;
+  uint64_t end;
+  uint64_t offset = append(entry, end);
+  if (offset == 0 || !link(key, offset))
+    return false;
+  header_of(file_)->data_end = end;
+  return true;
+}
+
+bool SolutionCache::alias(CacheKey from, CacheKey to) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!is_open())
+    return false;
+  if (slots_of(file_)[probe(from)].offset == 0 || !reserve_slot())
+    return false;
+  return link(to, slots_of(file_)[probe(from)].offset);
+}
+
+size_t SolutionCache::nkeys() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return is_open() ? header_of(file_)->nused : 0;
+}
+
+bool cached_solve_file(SolutionCache &cache, const string &path,
+                       VCWorkspace &ws, VCSolution &sol, bool *hit) {
+  sol = VCSolution();
+  MappedFile in;
+  if (!in.map(path.c_str(), false))
+    return false;
+  CacheKey ck = content_key(in.data(), in.size());
+  CacheEntry entry;
+  bool found = cache.find(ck, entry);
+
+  // same graph may come in other file: parse, but do not solve
+  if (!found) {
+    VCProblem p;
+    istringstream iss(in.size() ? string(in.data(), in.size()) : string());
+    read_graph_from_stream(iss, p);
+    CacheKey gk = graph_key(p);
+    found = cache.find(gk, entry);
+    if (!found) {
+      entry.n = p.n;
+      entry.solution = ws.solve(p);
+      entry.lpclasses = ws.lp_classes();
+      if (entry.solution.complete)
+        cache.insert(gk, entry);
+    }
+    cache.alias(gk, ck);
+  }
+  if (hit)
+    *hit = found;
+  sol = std::move(entry.solution);
+  return true;
+}
+}
@@ -0,0 +1,123 @@
+//===-- KGCache.hpp -- persistent content-addressed solution cache --------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// CacheKey -- 128-bit hash, two independent 64-bit mixes
+//
+// graph_key -- key of problem as labeled: n, then edge set with every
+//              edge as (min, max), sorted and deduplicated, so repeats,
+//              order of p.edges and order of ends do not matter; labels
+//              do, see limitation below
+//
+// content_key -- key of raw input bytes, cheap check before any parsing
+//
+// SolutionCache -- hash table of keys to solutions (cover, size, bounds,
+//                  LP classes) in one memory-mapped file
+//
+// cached_solve_file -- input file to solution: content key, then graph
+//                      key, then solve; every miss is stored under both
+//
+// File layout, all integers native:
+//   header -- magic, number of slots, used slots, end of data
+//   slots  -- open addressing, linear probing: key and record offset
+//             (0 for empty); several keys may share one record
+//   data   -- records appended: fixed part, cover, LP classes (byte per
+//             vertex), padded to 8 bytes
+// Table is rebuilt with twice the slots when half full, data region grows
+// by doubling file.
+//
+// Limitation: graph key is not isomorphism invariant. Vertex ids are
+// labels of read_graph_from_stream, given in order of first appearance,
+// so same edge list with lines reordered ("a b", "b c" against "b c",
+// "a b") or with other names gets other labels and misses. Cover is
+// stored in these labels too; canonical labeling of whole graphs is out
+// of reach here (see KGCanon.hpp for small components).
+//
+// All members lock one mutex, so cache may be shared by threads of one
+// process. Several processes shall not write one file at once.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KCACHE_GUARD__
+#define GRAPH_KCACHE_GUARD__
+
+#include "KGMapped.hpp"
+#include "KGSolver.hpp"
+
+namespace KGR {
+
+struct CacheKey {
+  uint64_t h1 = 0, h2 = 0;
+  friend bool operator==(CacheKey lhs, CacheKey rhs) {
+    return lhs.h1 == rhs.h1 && lhs.h2 == rhs.h2;
+  }
+};
+
+// words are mixed one by one, see KGCache.cpp
+class KeyHasher final {
+  uint64_t h1_ = 0x9e3779b97f4a7c15ull, h2_ = 0x243f6a8885a308d3ull;
+
+public:
+  void add(uint64_t word);
+  void add_bytes(const char *data, size_t size);
+  CacheKey key() const;
+};
+
+CacheKey graph_key(const VCProblem &p);
+CacheKey content_key(const char *data, size_t size);
+
+// what is stored per graph
+struct CacheEntry {
+  int n = 0;             // vertices of problem
+  VCSolution solution;   // cover, size, LP bound, kernel size
+  vector<int> lpclasses; // 0, 1, 2 per vertex, may be empty
+};
+
+class SolutionCache final {
+  string path_;
+  MappedFile file_;
+  std::mutex mutex_;
+
+  bool create(size_t nslots);
+  bool grow_data(size_t need);
+  bool rehash();
+  size_t probe(CacheKey key) const;
+  uint64_t append(const CacheEntry &entry, uint64_t &end);
+  bool reserve_slot();
+  bool link(CacheKey key, uint64_t offset);
+
+public:
+  SolutionCache() = default;
+  SolutionCache(const SolutionCache &) = delete;
+  SolutionCache &operator=(const SolutionCache &) = delete;
+
+  // opens file or creates empty one, false on I/O error or bad magic
+  bool open(const string &path);
+  void close();
+  bool is_open() const { return file_.data() != nullptr; }
+
+  bool find(CacheKey key, CacheEntry &entry);
+
+  // false if key is already there (record is kept) or on I/O error
+  bool insert(CacheKey key, const CacheEntry &entry);
+
+  // one more key for record of existing key, false if from is absent
+  // or to is already there
+  bool alias(CacheKey from, CacheKey to);
+
+  size_t nkeys();
+};
+
+// on miss problem is parsed and solved by ws, solution stored
+// false if file can not be read, hit (if given) tells if solve was skipped
+bool cached_solve_file(SolutionCache &cache, const string &path,
+                       VCWorkspace &ws, VCSolution &sol,
+                       bool *hit = nullptr);
+}
+
+#endif
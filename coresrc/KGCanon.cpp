@@ -0,0 +1,282 @@
+//===-- KGCanon.cpp -- canonical labeling and cover memo supplement -------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGCanon.hpp"
+
+namespace KGR {
+
+static uint32_t bit(int v) { return uint32_t(1) << v; }
+
+// ordered partition of vertices, cell is bitset
+struct Partition {
+  int ncells = 0;
+  uint32_t cells[canon_max];
+};
+
+// best leaf so far and limit
+struct CanonSearch {
+  const SmallGraph &g;
+  CanonForm best;
+  int perm[canon_max];
+  bool found = false;
+  size_t leaves = 0, maxleaves;
+
+  CanonSearch(const SmallGraph &graph, size_t limit)
+      : g(graph), maxleaves(limit) {}
+};
+
+// every cell split by number of neighbors in every cell until nothing
+// changes; parts go in ascending count, so result depends on structure
+// and order of cells only, never on labels
+static void refine(const SmallGraph &g, Partition &p) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int s = 0; s < p.ncells; ++s) {
+      uint32_t splitter = p.cells[s];
+      for (int c = 0; c < p.ncells; ++c) {
+        uint32_t cell = p.cells[c];
+        if ((cell & (cell - 1)) == 0)
+          continue;
+        uint64_t counts = 0;
+        for (uint32_t m = cell; m != 0; m &= m - 1) {
+          int v = __builtin_ctz(m);
+          counts |= uint64_t(1) << __builtin_popcount(g.adj[v] & splitter);
+        }
+        if ((counts & (counts - 1)) == 0)
+          continue;
+
+        uint32_t parts[canon_max + 1];
+        int nparts = 0;
+        for (uint64_t k = counts; k != 0; k &= k - 1) {
+          int cnt = __builtin_ctzll(k);
+          uint32_t part = 0;
+          for (uint32_t m = cell; m != 0; m &= m - 1) {
+            int v = __builtin_ctz(m);
+            if (__builtin_popcount(g.adj[v] & splitter) == cnt)
+              part |= bit(v);
+          }
+          parts[nparts++] = part;
+        }
+        std::copy_backward(p.cells + c + 1, p.cells + p.ncells,
+                           p.cells + p.ncells + nparts - 1);
+        std::copy(parts, parts + nparts, p.cells + c);
+        p.ncells += nparts - 1;
+        changed = true;
+      }
+    }
+  }
+}
+
+// discrete partition is order of vertices; rows of relabeled graph
+static void leaf_form(const SmallGraph &g, const Partition &p,
+                      CanonForm &form, int *perm) {
+  int pos[canon_max];
+  form.n = g.n;
+  for (int i = 0; i != g.n; ++i) {
+    perm[i] = __builtin_ctz(p.cells[i]);
+    pos[perm[i]] = i;
+  }
+  for (int i = 0; i != g.n; ++i) {
+    uint32_t row = 0;
+    for (uint32_t m = g.adj[perm[i]]; m != 0; m &= m - 1)
+      row |= bit(pos[__builtin_ctz(m)]);
+    form.rows[i] = row;
+  }
+}
+
+// false when leaf limit is exceeded
+static bool canon_search(CanonSearch &cs, Partition &p) {
+  refine(cs.g, p);
+  if (p.ncells == cs.g.n) {
+    if (++cs.leaves > cs.maxleaves)
+      return false;
+    CanonForm form;
+    int perm[canon_max];
+    leaf_form(cs.g, p, form, perm);
+    if (!cs.found || form < cs.best) {
+      cs.best = form;
+      std::copy(perm, perm + cs.g.n, cs.perm);
+      cs.found = true;
+    }
+    return true;
+  }
+
+  int target = -1, tsize = canon_max + 1;
+  for (int c = 0; c != p.ncells; ++c) {
+    int sz = __builtin_popcount(p.cells[c]);
+    if (sz > 1 && sz < tsize) {
+      target = c;
+      tsize = sz;
+    }
+  }
+
+  uint32_t cell = p.cells[target], tried = 0;
+  for (uint32_t m = cell; m != 0; m &= m - 1) {
+    int v = __builtin_ctz(m);
+    bool twin = false;
+    for (uint32_t t = tried; t != 0 && !twin; t &= t - 1) {
+      int u = __builtin_ctz(t);
+      twin = ((cs.g.adj[u] & ~bit(v)) == (cs.g.adj[v] & ~bit(u)));
+    }
+    if (twin)
+      continue;
+    tried |= bit(v);
+
+    Partition q;
+    q.ncells = p.ncells + 1;
+    std::copy(p.cells, p.cells + target, q.cells);
+    q.cells[target] = bit(v);
+    q.cells[target + 1] = cell & ~bit(v);
+    std::copy(p.cells + target + 1, p.cells + p.ncells, q.cells + target + 2);
+    if (!canon_search(cs, q))
+      return false;
+  }
+  return true;
+}
+
+// initial partition is one cell, degrees come from first refinement
+bool canonical_form(const SmallGraph &g, CanonForm &form, int *perm,
+                    size_t maxleaves) {
+  assert(g.n >= 0 && g.n <= canon_max);
+  form = CanonForm();
+  if (g.n == 0)
+    return true;
+  CanonSearch cs(g, maxleaves);
+  Partition p;
+  p.ncells = 1;
+  p.cells[0] = (g.n == 32) ? ~uint32_t(0) : bit(g.n) - 1;
+  if (!canon_search(cs, p))
+    return false;
+  form = cs.best;
+  std::copy(cs.perm, cs.perm + g.n, perm);
+  return true;
+}
+
+size_t CanonFormHash::operator()(const CanonForm &f) const {
+  uint64_t h = 0x9e3779b97f4a7c15ull ^ f.n;
+  for (int i = 0; i != f.n; ++i) {
+    h ^= f.rows[i];
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 29;
+  }
+  return h;
+}
+
+// alive: undecided vertices; taking v removes it, edges to taken
+// vertices are covered; bound is ceil(m / dmax)
+static void cover_branch(const SmallGraph &g, uint32_t alive, uint32_t taken,
+                         int size, uint32_t &best, int &bestsz) {
+  if (size >= bestsz)
+    return;
+  int vmax = -1, dmax = 0, leaf = -1, degsum = 0;
+  for (uint32_t m = alive; m != 0; m &= m - 1) {
+    int v = __builtin_ctz(m);
+    int d = __builtin_popcount(g.adj[v] & alive);
+    degsum += d;
+    if (d == 1)
+      leaf = v;
+    if (d > dmax) {
+      dmax = d;
+      vmax = v;
+    }
+  }
+  if (dmax == 0) {
+    best = taken;
+    bestsz = size;
+    return;
+  }
+  if (size + (degsum / 2 + dmax - 1) / dmax >= bestsz)
+    return;
+
+  // some minimum cover takes neighbor of leaf
+  if (leaf != -1) {
+    int u = __builtin_ctz(g.adj[leaf] & alive);
+    cover_branch(g, alive & ~bit(u) & ~bit(leaf), taken | bit(u), size + 1,
+                 best, bestsz);
+    return;
+  }
+
+  cover_branch(g, alive & ~bit(vmax), taken | bit(vmax), size + 1, best,
+               bestsz);
+  uint32_t nbs = g.adj[vmax] & alive;
+  cover_branch(g, alive & ~nbs & ~bit(vmax), taken | nbs,
+               size + __builtin_popcount(nbs), best, bestsz);
+}
+
+// non-isolated vertices are first cover
+uint32_t small_min_cover(const SmallGraph &g) {
+  uint32_t best = 0;
+  for (int v = 0; v != g.n; ++v)
+    if (g.adj[v] != 0)
+      best |= bit(v);
+  int bestsz = __builtin_popcount(best);
+  cover_branch(g, best, 0, 0, best, bestsz);
+  return best;
+}
+
+// memo keeps cover in canonical labels; solving runs outside of lock
+uint32_t CoverMemo::cover(const SmallGraph &g, bool *hit) {
+  CanonForm form;
+  int perm[canon_max];
+  if (hit)
+    *hit = false;
+  if (!canonical_form(g, form, perm))
+    return small_min_cover(g);
+
+  uint32_t canon = 0;
+  bool found = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = table_.find(form);
+    found = (it != table_.end());
+    if (found) {
+      canon = it->second;
+      nhits_ += 1;
+    } else
+      nmisses_ += 1;
+  }
+
+  uint32_t res = 0;
+  if (found) {
+    for (uint32_t m = canon; m != 0; m &= m - 1)
+      res |= bit(perm[__builtin_ctz(m)]);
+  } else {
+    res = small_min_cover(g);
+    for (int i = 0; i != g.n; ++i)
+      if (res & bit(perm[i]))
+        canon |= bit(i);
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_.emplace(form, canon);
+  }
+  if (hit)
+    *hit = found;
+  return res;
+}
+
+size_t CoverMemo::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return table_.size();
+}
+
+size_t CoverMemo::hits() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nhits_;
+}
+
+size_t CoverMemo::misses() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nmisses_;
+}
+
+void CoverMemo::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  table_.clear();
+  nhits_ = 0;
+  nmisses_ = 0;
+}
+}
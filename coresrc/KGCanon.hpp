@@ -0,0 +1,98 @@
+//===-- KGCanon.hpp -- canonical labeling and cover memo for small graphs -===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// SmallGraph -- at most canon_max vertices, adjacency row is bitset
+//
+// CanonForm -- adjacency rows of graph relabeled to canonical order, equal
+//              for isomorphic graphs only
+//
+// canonical_form -- individualization-refinement: partition refined by
+//                   neighbor counts until equitable, then every vertex of
+//                   first smallest non-singleton cell individualized in
+//                   turn; leaf with least rows is canonical. Twins (same
+//                   neighbors apart from each other) give same leaves, so
+//                   only first of them is tried. Gives up after maxleaves
+//
+// small_min_cover -- minimum cover mask by branching on bitsets
+//
+// CoverMemo -- canonical form to minimum cover, shared by threads: every
+//              isomorphic copy after first costs labeling and lookup
+//              instead of search
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KCANON_GUARD__
+#define GRAPH_KCANON_GUARD__
+
+#include "KGInc.hpp"
+
+namespace KGR {
+
+constexpr int canon_max = 32;
+
+struct SmallGraph {
+  int n = 0;
+  uint32_t adj[canon_max] = {};
+
+  void add_edge(int u, int v) {
+    assert(u >= 0 && u < n && v >= 0 && v < n && u != v);
+    adj[u] |= uint32_t(1) << v;
+    adj[v] |= uint32_t(1) << u;
+  }
+};
+
+struct CanonForm {
+  int n = 0;
+  uint32_t rows[canon_max] = {}; // only first n are used
+
+  friend bool operator==(const CanonForm &lhs, const CanonForm &rhs) {
+    return lhs.n == rhs.n &&
+           std::equal(lhs.rows, lhs.rows + lhs.n, rhs.rows);
+  }
+  friend bool operator<(const CanonForm &lhs, const CanonForm &rhs) {
+    if (lhs.n != rhs.n)
+      return lhs.n < rhs.n;
+    return std::lexicographical_compare(lhs.rows, lhs.rows + lhs.n,
+                                        rhs.rows, rhs.rows + rhs.n);
+  }
+};
+
+struct CanonFormHash {
+  size_t operator()(const CanonForm &f) const;
+};
+
+// perm[i] is vertex of g at canonical position i
+// false if more than maxleaves leaves were needed (form is then unset)
+bool canonical_form(const SmallGraph &g, CanonForm &form, int *perm,
+                    size_t maxleaves = 4096);
+
+uint32_t small_min_cover(const SmallGraph &g);
+
+class CoverMemo final {
+  unordered_map<CanonForm, uint32_t, CanonFormHash> table_;
+  size_t nhits_ = 0, nmisses_ = 0;
+  std::mutex mutex_;
+
+public:
+  CoverMemo() = default;
+  CoverMemo(const CoverMemo &) = delete;
+  CoverMemo &operator=(const CoverMemo &) = delete;
+
+  // minimum cover of g as mask over its own labels
+  // graphs with too many automorphisms are solved without memo
+  uint32_t cover(const SmallGraph &g, bool *hit = nullptr);
+
+  size_t size();
+  size_t hits();
+  size_t misses();
+  void clear();
+};
+}
+
+#endif
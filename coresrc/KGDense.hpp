@@ -0,0 +1,324 @@
+//===-- KGDense.hpp -- dense graph as adjacency bit matrix ----------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// BitGraph -- row u of matrix has bit v set iff uv is edge
+//
+// Edge test is one bit, degree is popcount of row, common neighborhood is
+// AND of two rows. Arcs of u are set bits of row u in ascending order, so
+// BitGraph has the same handle descriptors as Graph and algorithms from
+// KGAlg.hpp work unchanged. Edge is 1 bit instead of two heap Edge nodes.
+//
+// Edge loads are kept densely per arc, arc number is rank of its bit: per
+// word prefix counts make it O(1). Ranks and edge loads are rebuilt lazily
+// after topology changes; bits set since last rebuild are marked, so
+// rebuild moves loads of old arcs to their new numbers and gives new arcs
+// default loads. Setting existing bit (repeated add_link) changes nothing.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KDENSE_GUARD__
+#define GRAPH_KDENSE_GUARD__
+
+#include "KGraph.hpp"
+
+namespace KGR {
+
+template <typename VL, typename EL> class BitGraph final {
+  int n_ = 0;
+  int words_ = 0;         // 64-bit words per row
+  vector<uint64_t> bits_; // n_ rows of words_ words
+  vector<VL> vloads_;
+
+  // lazily built: set bits before each word, loads per arc
+  // eloads_ has loads of arcs of bits_ & ~fresh_, row by row; fresh_ has
+  // same layout as bits_ or is empty if nothing was set since rebuild
+  bool dirty_ = true;
+  vector<uint32_t> ranks_;
+  vector<EL> eloads_;
+  vector<uint64_t> fresh_;
+
+  uint64_t *row(int u) { return bits_.data() + (size_t)u * words_; }
+
+  // bits of mask not yet in word w become arcs, true if there were any
+  bool set_word(size_t w, uint64_t mask) {
+    uint64_t added = mask & ~bits_[w];
+    if (added == 0)
+      return false;
+    if (fresh_.empty())
+      fresh_.assign(bits_.size(), 0);
+    bits_[w] |= added;
+    fresh_[w] |= added;
+    dirty_ = true;
+    return true;
+  }
+
+  void set_bit(int u, int v) {
+    set_word((size_t)u * words_ + v / 64, uint64_t(1) << (v % 64));
+  }
+
+  // sets bits [lo, hi) in row u, word at a time
+  void set_range(int u, int lo, int hi) {
+    for (int w = lo / 64; w <= (hi - 1) / 64 && lo < hi; ++w) {
+      int wlo = std::max(lo, w * 64) - w * 64;
+      int whi = std::min(hi, w * 64 + 64) - w * 64;
+      uint64_t mask = (whi == 64) ? ~uint64_t(0) : (uint64_t(1) << whi) - 1;
+      mask &= ~((uint64_t(1) << wlo) - 1);
+      set_word((size_t)u * words_ + w, mask);
+    }
+  }
+
+  // clears bit set since last rebuild, it has no load yet
+  void clear_fresh_bit(int u, int v) {
+    size_t w = (size_t)u * words_ + v / 64;
+    uint64_t mask = uint64_t(1) << (v % 64);
+    assert(!fresh_.empty() && (fresh_[w] & mask));
+    bits_[w] &= ~mask;
+    fresh_[w] &= ~mask;
+  }
+
+  // first set bit at or after v in row u, n_ if none
+  int scan(int u, int v) {
+    if (v >= n_)
+      return n_;
+    const uint64_t *r = row(u);
+    int w = v / 64;
+    uint64_t word = r[w] & (~uint64_t(0) << (v % 64));
+    while (word == 0) {
+      if (++w == words_)
+        return n_;
+      word = r[w];
+    }
+    return w * 64 + __builtin_ctzll(word);
+  }
+
+  void build_ranks() {
+    ranks_.resize(bits_.size());
+    uint32_t sum = 0;
+    for (size_t w = 0; w != bits_.size(); ++w) {
+      ranks_[w] = sum;
+      sum += __builtin_popcountll(bits_[w]);
+    }
+
+    // old arcs keep row by row order, new ones are put in between
+    if (!fresh_.empty()) {
+      vector<EL> loads;
+      loads.reserve(sum);
+      size_t old = 0;
+      for (size_t w = 0; w != bits_.size(); ++w)
+        for (uint64_t m = bits_[w]; m != 0; m &= m - 1) {
+          if (fresh_[w] & m & -m)
+            loads.push_back(EL{});
+          else
+            loads.push_back(eloads_[old++]);
+        }
+      assert(old == eloads_.size());
+      eloads_.swap(loads);
+      fresh_.clear();
+    }
+    assert(eloads_.size() == sum);
+    dirty_ = false;
+  }
+
+public:
+  struct ArcPos {
+    uint32_t u, v;
+    friend bool operator==(ArcPos lhs, ArcPos rhs) {
+      return lhs.u == rhs.u && lhs.v == rhs.v;
+    }
+  };
+
+  // storage interface for handles
+public:
+  using VLoad = VL;
+  using ELoad = EL;
+  VL &vload(uint32_t v) { return vloads_[v]; }
+  EL &eload(ArcPos a) { return eloads_[arc_number(a)]; }
+  ArcPos first_arc(uint32_t u) {
+    int v = scan(u, 0);
+    return (v == n_) ? nil_arc() : ArcPos{u, (uint32_t)v};
+  }
+  ArcPos next_arc(ArcPos a) {
+    int v = scan(a.u, a.v + 1);
+    return (v == n_) ? nil_arc() : ArcPos{a.u, (uint32_t)v};
+  }
+  uint32_t arc_tip(ArcPos a) { return a.v; }
+  static ArcPos nil_arc() { return {nil_index, nil_index}; }
+
+  // arcs are numbered row by row, this is rank of arc bit
+  uint32_t arc_number(ArcPos a) {
+    if (dirty_)
+      build_ranks();
+    size_t w = (size_t)a.u * words_ + a.v / 64;
+    uint64_t below = bits_[w] & ((uint64_t(1) << (a.v % 64)) - 1);
+    return ranks_[w] + __builtin_popcountll(below);
+  }
+
+public:
+  BitGraph() = default;
+
+  // same vertex order and loads, arcs come in ascending order
+  explicit BitGraph(GraphBuilder<VL, EL> &src) {
+    add_isolated(src.nvertices());
+    for (auto vd : src) {
+      vloads_[src.index(vd)] = vd->load;
+      for (auto ed = vd->arcs; ed != src.last_edge(); ed = ed->next)
+        set_bit(src.index(vd), src.index(ed->tip));
+    }
+    build_ranks();
+    for (auto vd : src)
+      for (auto ed = vd->arcs; ed != src.last_edge(); ed = ed->next)
+        eloads_[arc_number({(uint32_t)src.index(vd),
+                            (uint32_t)src.index(ed->tip)})] = ed->load;
+  }
+
+  // general interface
+public:
+  using VertexDescriptor = VertexHandle<BitGraph>;
+  using EdgeDescriptor = EdgeHandle<BitGraph>;
+  using VertexIterator = IndexIterator<BitGraph>;
+  const char *name() const { return "G"; }
+  int nvertices() { return n_; }
+  VertexDescriptor front() { return vertex(0); }
+  VertexDescriptor back() { return vertex(n_ - 1); }
+  VertexIterator begin() { return VertexIterator(this, 0); }
+  VertexIterator end() { return VertexIterator(this, n_); }
+  VertexDescriptor last_vertex() { return VertexDescriptor(); }
+  EdgeDescriptor last_edge() { return EdgeDescriptor(this, nil_arc()); }
+  int index(VertexDescriptor vd) { return vd.index(); }
+  VertexDescriptor vertex(int i) {
+    assert(i >= 0 && i < n_);
+    return VertexDescriptor(this, i);
+  }
+  EdgeDescriptor get_edge(VertexDescriptor u, VertexDescriptor v) {
+    if (!adjacent(u, v))
+      return last_edge();
+    return EdgeDescriptor(this, ArcPos{u.index(), v.index()});
+  }
+  EdgeDescriptor get_sibling(EdgeDescriptor e, VertexDescriptor u) {
+    assert(e != last_edge() && u != last_vertex());
+    return get_edge(e->tip, u);
+  }
+  int degree(VertexDescriptor u) {
+    const uint64_t *r = row(u.index());
+    int deg = 0;
+    for (int w = 0; w != words_; ++w)
+      deg += __builtin_popcountll(r[w]);
+    return deg;
+  }
+
+  // dense specifics
+public:
+  bool adjacent(VertexDescriptor u, VertexDescriptor v) {
+    assert(u != last_vertex() && v != last_vertex());
+    return (row(u.index())[v.index() / 64] >> (v.index() % 64)) & 1;
+  }
+
+  // |N(u) & N(v)|, word-parallel
+  int common_degree(VertexDescriptor u, VertexDescriptor v) {
+    const uint64_t *ru = row(u.index()), *rv = row(v.index());
+    int cnt = 0;
+    for (int w = 0; w != words_; ++w)
+      cnt += __builtin_popcountll(ru[w] & rv[w]);
+    return cnt;
+  }
+
+  // raw row of words_ words, for custom word-parallel kernels
+  const uint64_t *neighbors(VertexDescriptor u) { return row(u.index()); }
+  int row_words() const { return words_; }
+
+  // modifiable specifics, same as GraphBuilder
+public:
+  void cleanup() {
+    n_ = words_ = 0;
+    bits_.clear();
+    vloads_.clear();
+    eloads_.clear();
+    fresh_.clear();
+    dirty_ = true;
+  }
+
+  int add_default_vertex() {
+    add_isolated(1);
+    return n_ - 1;
+  }
+
+  // add n isolated vertices, rows are relaid if they need more words
+  void add_isolated(int n) {
+    int nn = n_ + n;
+    int nwords = (nn + 63) / 64;
+    if (nwords != words_) {
+      auto relay = [this, nn, nwords](vector<uint64_t> &v) {
+        vector<uint64_t> nv((size_t)nn * nwords, 0);
+        for (int u = 0; u != n_; ++u)
+          std::copy(v.data() + (size_t)u * words_,
+                    v.data() + (size_t)(u + 1) * words_,
+                    nv.data() + (size_t)u * nwords);
+        v.swap(nv);
+      };
+      relay(bits_);
+      if (!fresh_.empty())
+        relay(fresh_);
+      words_ = nwords;
+    } else {
+      bits_.resize((size_t)nn * words_, 0);
+      if (!fresh_.empty())
+        fresh_.resize(bits_.size(), 0);
+    }
+    vloads_.resize(nn);
+    n_ = nn;
+    dirty_ = true;
+  }
+
+  void add_link(int i, int j) {
+    assert(i >= 0 && i < n_);
+    assert(j >= 0 && j < n_);
+    assert(i != j && "Loops are not supported");
+    set_bit(i, j);
+    set_bit(j, i);
+  }
+
+  void add_path(int n) {
+    int start = n_;
+    add_isolated(n);
+    for (int i = start; i + 1 < start + n; ++i)
+      add_link(i, i + 1);
+  }
+
+  void add_cycle(int n) {
+    int start = n_;
+    add_path(n);
+    assert(n > 2);
+    add_link(start, start + n - 1);
+  }
+
+  void add_clique(int n) {
+    assert(n > 2);
+    int start = n_;
+    add_isolated(n);
+    for (int i = start; i != start + n; ++i) {
+      set_range(i, start, start + n);
+      clear_fresh_bit(i, i);
+    }
+  }
+
+  void add_full_bipart(int n, int m) {
+    int start = n_;
+    add_isolated(n + m);
+    for (int i = start; i != start + n; ++i)
+      set_range(i, start + n, start + n + m);
+    for (int j = start + n; j != start + n + m; ++j)
+      set_range(j, start, start + n);
+  }
+
+  friend ostream &operator<<(ostream &stream, BitGraph &g) {
+    out_dot_to_stream(stream, g);
+    return stream;
+  }
+};
+}
+
+#endif
@@ -0,0 +1,349 @@
+//===-- KGDynamic.hpp -- matching and LP cover under edge updates ---------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// DynamicMatching -- maximum matching in bipartite double of GraphBuilder,
+//                    kept maximum while edges are inserted and deleted
+//
+// Double is implicit as in VCWorkspace: left u adjacent to right v iff uv
+// is edge. Matching size is 2x LP value, LP classes (Nemhauser-Trotter
+// kernel) come from Koenig cover of this matching.
+//
+// Link u-v is two double edges (u, v') and (v, u'), they are applied one
+// at a time: second one is hidden while first is repaired on insert, and
+// unmatched one goes first on delete. One edge changes matching size by at
+// most one, and augmenting path, if any, passes through changed edge:
+//   insert (a, b') -- if left a is matched, even alternating path from free
+//                     left vertex to a is flipped first (size is the same,
+//                     a becomes free), then one search from a
+//   delete (a, b') -- if it was matched, one search forward from left a,
+//                     then one search backward from right b
+//
+// Every search from one vertex races with dual search from all free
+// vertices of other end, vertex by vertex. Whichever is exhausted first
+// proves there is no path, so cost is the smaller of two alternating
+// reaches. Near-perfect matchings have few free vertices and updates touch
+// only small neighborhoods.
+//
+// Koenig cover and LP classes are derived lazily, on first query after
+// updates: O(V + E).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KDYNAMIC_GUARD__
+#define GRAPH_KDYNAMIC_GUARD__
+
+#include "KGraph.hpp"
+#include "KGSolver.hpp"
+
+namespace KGR {
+
+template <typename VL, typename EL> class DynamicMatching final {
+  GraphBuilder<VL, EL> &g_;
+  int matching_ = 0;
+
+  // side 0 is left, 1 is right; mate is on other side, -1 for free
+  vector<int> mate_[2];
+
+  // free vertices of each side and their positions there
+  vector<int> free_[2], fpos_[2];
+
+  // alternating BFS from side s: unmatched edge to other side, discovered
+  // vertex is marked, matched edge back to side s is queued
+  // sources are one vertex or all free vertices of side s
+  struct Walk {
+    const vector<int> *sources = nullptr;
+    size_t spos = 0, qpos = 0;
+    vector<int> queue, prev;
+    vector<unsigned> seen;
+    unsigned stamp = 0;
+
+    void start(const vector<int> *srcs, int src) {
+      sources = srcs;
+      spos = qpos = 0;
+      queue.clear();
+      if (src != -1)
+        queue.push_back(src);
+      if (++stamp == 0) {
+        std::fill(seen.begin(), seen.end(), 0);
+        stamp = 1;
+      }
+    }
+
+    int pop() {
+      if (sources && spos != sources->size())
+        return (*sources)[spos++];
+      if (qpos != queue.size())
+        return queue[qpos++];
+      return -1;
+    }
+  };
+  Walk walk_[2];
+
+  // double edge left hide_l_ - right hide_r_ is not yet inserted
+  int hide_l_ = -1, hide_r_ = -1;
+
+  // lazily derived 0/1/2 per vertex
+  vector<int> lpclass_;
+  bool dirty_ = true;
+
+  void set_mate(int s, int x, int y) {
+    mate_[s][x] = y;
+    if (y == -1 && fpos_[s][x] == -1) {
+      fpos_[s][x] = free_[s].size();
+      free_[s].push_back(x);
+    } else if (y != -1 && fpos_[s][x] != -1) {
+      int last = free_[s].back();
+      free_[s][fpos_[s][x]] = last;
+      fpos_[s][last] = fpos_[s][x];
+      free_[s].pop_back();
+      fpos_[s][x] = -1;
+    }
+  }
+
+  void match(int s, int x, int y) {
+    set_mate(s, x, y);
+    set_mate(1 - s, y, x);
+  }
+
+  // new vertices are free on both sides, LP classes need one more entry
+  void sync() {
+    int old = mate_[0].size(), n = g_.nvertices();
+    if (n > old)
+      dirty_ = true;
+    for (int s = 0; s != 2; ++s) {
+      mate_[s].resize(n, 0);
+      fpos_[s].resize(n, -1);
+      walk_[s].prev.resize(n, -1);
+      walk_[s].seen.resize(n, 0);
+    }
+    for (int v = old; v < n; ++v) {
+      set_mate(0, v, -1);
+      set_mate(1, v, -1);
+    }
+  }
+
+  bool hidden(int s, int x, int y) const {
+    return (s == 0) ? (x == hide_l_ && y == hide_r_)
+                    : (y == hide_l_ && x == hide_r_);
+  }
+
+  // expands one vertex of walk w from side s
+  // returns discovered vertex with goal, -1 if exhausted, -2 otherwise
+  template <typename C> int advance(Walk &w, int s, C goal) {
+    int x = w.pop();
+    if (x == -1)
+      return -1;
+    auto enil = g_.last_edge();
+    for (auto e = g_.vertex(x)->arcs; e != enil; e = e->next) {
+      int y = g_.index(e->tip);
+      if (y == mate_[s][x] || w.seen[y] == w.stamp || hidden(s, x, y))
+        continue;
+      w.seen[y] = w.stamp;
+      w.prev[y] = x;
+      if (goal(y))
+        return y;
+      if (mate_[1 - s][y] != -1)
+        w.queue.push_back(mate_[1 - s][y]);
+    }
+    return -2;
+  }
+
+  // both walks in turn, returns which one found goal at found, or -1 when
+  // either is exhausted: then there is no path at all
+  template <typename C0, typename C1>
+  int race(int s0, C0 goal0, int s1, C1 goal1, int &found) {
+    for (;;) {
+      int r = advance(walk_[0], s0, goal0);
+      if (r != -2) {
+        found = r;
+        return (r == -1) ? -1 : 0;
+      }
+      r = advance(walk_[1], s1, goal1);
+      if (r != -2) {
+        found = r;
+        return (r == -1) ? -1 : 1;
+      }
+    }
+  }
+
+  // flips path of walk w from side s ending at discovered y, back to free
+  // source or to src
+  void flip(Walk &w, int s, int y, int src) {
+    for (;;) {
+      int x = w.prev[y];
+      int old = mate_[s][x];
+      match(s, x, y);
+      if (old == -1 || x == src)
+        break;
+      y = old;
+    }
+  }
+
+  // free u on side s to free vertex of other side
+  bool augment(int s, int u) {
+    assert(mate_[s][u] == -1);
+    int found, t = 1 - s;
+    walk_[0].start(nullptr, u);
+    walk_[1].start(&free_[t], -1);
+    int who = race(s, [this, t](int y) { return mate_[t][y] == -1; }, t,
+                   [u](int y) { return y == u; }, found);
+    if (who == -1)
+      return false;
+    flip(walk_[who], who ? t : s, found, -1);
+    return true;
+  }
+
+  // matched left a becomes free by flipping even alternating path from
+  // some free left vertex, matching size stays the same
+  bool release(int a) {
+    int r0 = mate_[0][a];
+    assert(r0 != -1);
+    int found;
+    walk_[0].start(nullptr, r0);
+    walk_[1].start(&free_[0], -1);
+    int who = race(1, [this](int y) { return mate_[0][y] == -1; }, 0,
+                   [r0](int y) { return y == r0; }, found);
+    if (who == -1)
+      return false;
+    if (who == 0)
+      flip(walk_[0], 1, found, r0);
+    else
+      flip(walk_[1], 0, found, -1);
+    set_mate(0, a, -1);
+    return true;
+  }
+
+  // new double edge left a - right b
+  void repair_insert(int a, int b) {
+    if (mate_[0][a] == -1 && mate_[1][b] == -1) {
+      match(0, a, b);
+      matching_ += 1;
+      return;
+    }
+    if (mate_[0][a] != -1 && !release(a))
+      return;
+    if (augment(0, a))
+      matching_ += 1;
+  }
+
+  // double edge left a - right b is gone
+  void repair_delete(int a, int b) {
+    if (mate_[0][a] != b)
+      return;
+    set_mate(0, a, -1);
+    set_mate(1, b, -1);
+    matching_ -= 1;
+    if (augment(0, a) || augment(1, b))
+      matching_ += 1;
+  }
+
+public:
+  // initial matching is from flat Hopcroft-Karp of VCWorkspace
+  explicit DynamicMatching(GraphBuilder<VL, EL> &g) : g_(g) {
+    sync();
+    VCProblem p;
+    VCWorkspace ws;
+    p.add_isolated(g_.nvertices());
+    for (auto vd : g_)
+      for (auto e = vd->arcs; e != g_.last_edge(); e = e->next)
+        if (g_.index(vd) < g_.index(e->tip))
+          p.add_link(g_.index(vd), g_.index(e->tip));
+    ws.load(p);
+    matching_ = ws.lp_kernel();
+    for (int u = 0; u != p.n; ++u)
+      if (ws.double_mates()[u] != -1)
+        match(0, u, ws.double_mates()[u]);
+  }
+
+  DynamicMatching(const DynamicMatching &) = delete;
+  DynamicMatching &operator=(const DynamicMatching &) = delete;
+
+  // new vertices, added here or directly to graph, start isolated
+  int add_vertex() {
+    int v = g_.add_default_vertex();
+    sync();
+    return v;
+  }
+
+  void insert(int u, int v) {
+    assert(u != v && "Loops are not supported");
+    sync();
+    bool fresh = (g_.get_edge(g_.vertex(u), g_.vertex(v)) == g_.last_edge());
+    g_.add_link(u, v);
+    dirty_ = true;
+    // parallel link adds nothing to double
+    if (!fresh)
+      return;
+    hide_l_ = v;
+    hide_r_ = u;
+    repair_insert(u, v);
+    hide_l_ = hide_r_ = -1;
+    repair_insert(v, u);
+  }
+
+  // false if there was no such edge
+  bool remove(int u, int v) {
+    sync();
+    if (!g_.remove_link(u, v))
+      return false;
+    dirty_ = true;
+    // parallel link still carries matched pairs
+    if (g_.get_edge(g_.vertex(u), g_.vertex(v)) != g_.last_edge())
+      return true;
+    // matched edge is traversed only through mates, so it can stay
+    // in matching while other one is repaired
+    if (mate_[0][u] == v)
+      std::swap(u, v);
+    repair_delete(u, v);
+    repair_delete(v, u);
+    return true;
+  }
+
+  // maximum matching in double, equals 2x LP value
+  int matching() const { return matching_; }
+  int lp_bound() const { return (matching_ + 1) / 2; }
+  int mate(int u) const { return mate_[0][u]; }
+
+  // 0 (not in cover), 1 (kernel) or 2 (in cover) per vertex, same
+  // Koenig construction as VCWorkspace::lp_kernel
+  const vector<int> &lp_classes() {
+    sync();
+    if (!dirty_)
+      return lpclass_;
+    int n = g_.nvertices();
+    auto enil = g_.last_edge();
+    vector<char> inz(n, 0);
+    vector<int> queue(free_[0]);
+    lpclass_.assign(n, 1);
+    for (auto u : queue) {
+      inz[u] = 1;
+      lpclass_[u] -= 1;
+    }
+
+    for (size_t qpos = 0; qpos != queue.size(); ++qpos) {
+      int u = queue[qpos];
+      for (auto e = g_.vertex(u)->arcs; e != enil; e = e->next) {
+        int w = mate_[1][g_.index(e->tip)];
+        assert(w != -1 && "Augmenting path in maximum matching");
+        if (!inz[w]) {
+          inz[w] = 1;
+          lpclass_[w] -= 1;
+          queue.push_back(w);
+        }
+      }
+    }
+
+    for (int u = 0; u != n; ++u)
+      if (inz[u] && mate_[0][u] != -1)
+        lpclass_[mate_[0][u]] += 1;
+    dirty_ = false;
+    return lpclass_;
+  }
+};
+}
+
+#endif
@@ -25,3 +25,18 @@ int update_vertices(string s, map<string, int> &vertices, int &vidx) {
   vertices[s] = vidx;
   return vidx++;
 }
+
+void BufWriter::drain() {
+  if (pos_ == 0)
+    return;
+  if (stream_.rdbuf()->sputn(buf_.get(), pos_) != (std::streamsize)pos_)
+    stream_.setstate(std::ios::badbit);
+  pos_ = 0;
+}
+
+bool IntReader::refill() {
+  std::streamsize got = sb_->sgetn(buf_.data(), buf_.size());
+  cur_ = buf_.data();
+  end_ = cur_ + got;
+  return got > 0;
+}
@@ -7,12 +7,31 @@
 //
 // This file contains:
 //
+// BufWriter -- buffered writer, all writers below use it
+//
 // out_dot_to_stream -- outputs G in dot format
 //
 // out_mps_to_stream -- outputs G in mps format for vertex cover LPVC approx
 //
+// out_pace_to_stream -- outputs G in PACE 2019 .gr format
+//
+// out_dimacs_to_stream -- outputs G in DIMACS "p edge" format
+//
+// out_metis_to_stream -- outputs G in METIS adjacency format
+//
+// out_pace_vc_to_stream -- outputs vertex cover of G in PACE .vc format
+//
 // read_graph_from_stream -- reads G from file in simplest form (vertex pairs)
 //
+// for_each_edge -- calls function for every edge line of edge list, graph
+//                  itself is never built
+//
+// read_pace_from_stream -- reads G from PACE 2019 .gr format
+//
+// read_dimacs_from_stream -- reads G from DIMACS "p edge" format
+//
+// read_metis_from_stream -- reads G from METIS adjacency format
+//
 //===----------------------------------------------------------------------===//
 
 #ifndef GRAPH_KFMTS_GUARD__
@@ -26,101 +45,296 @@
 //
 //===----------------------------------------------------------------------===//
 
+// buffered writer directly to stream buffer
+// stream is never flushed, integers are formatted without allocations
+class BufWriter final {
+  ostream &stream_;
+  std::unique_ptr<char[]> buf_; // left uninitialized, only [0, pos_) is read
+  size_t size_;
+  size_t pos_ = 0;
+  void drain();
+
+public:
+  explicit BufWriter(ostream &stream, size_t bufsize = 1 << 16)
+      : stream_(stream), buf_(new char[bufsize]), size_(bufsize) {}
+  BufWriter(const BufWriter &) = delete;
+  BufWriter &operator=(const BufWriter &) = delete;
+  ~BufWriter() { drain(); }
+
+  // all put methods return number of chars written to allow padding
+  size_t put(char c) {
+    if (pos_ == size_)
+      drain();
+    buf_[pos_++] = c;
+    return 1;
+  }
+
+  size_t put(const char *s, size_t len) {
+    if (pos_ + len > size_)
+      drain();
+    if (len > size_) {
+      stream_.rdbuf()->sputn(s, len);
+      return len;
+    }
+    std::copy(s, s + len, buf_.get() + pos_);
+    pos_ += len;
+    return len;
+  }
+
+  size_t put(const char *s) {
+    return put(s, std::char_traits<char>::length(s));
+  }
+  size_t put(const string &s) { return put(s.data(), s.size()); }
+
+  size_t put_uint(unsigned long long n) {
+    char tmp[20];
+    char *end = tmp + sizeof(tmp), *cur = end;
+    do {
+      *--cur = '0' + n % 10;
+      n /= 10;
+    } while (n != 0);
+    return put(cur, end - cur);
+  }
+
+  size_t put_int(long long n) {
+    if (n >= 0)
+      return put_uint(n);
+    put('-');
+    return 1 + put_uint(0ull - n);
+  }
+
+  // like std::setw(width) << std::left for something already written
+  void pad(size_t written, size_t width) {
+    for (; written < width; ++written)
+      put(' ');
+  }
+};
+
+// any load printable to ostream can be written, but with allocation
+// loads in KGraph.hpp overload out_load directly
+template <typename L> void out_load(BufWriter &w, const L &load) {
+  ostringstream os;
+  os << load;
+  w.put(os.str());
+}
+
 // dot format: https://en.wikipedia.org/wiki/DOT_(graph_description_language)
 // useful for visualizations
 template <typename G> void out_dot_to_stream(ostream &stream, G &g) {
-  using VD = typename G::VertexDescriptor;
+  BufWriter w(stream);
   int n = 0;
-  map<VD, int> indexes;
-  stream << "graph " << g.name() << "{" << endl;
+  w.put("graph ");
+  w.put(g.name());
+  w.put("{\n");
   for (auto vd : g) {
-    stream << "v" << n << "[" << vd->load << "]"
-           << ";" << endl;
-    indexes[vd] = n;
+    w.put('v');
+    w.put_uint(n);
+    w.put('[');
+    out_load(w, vd->load);
+    w.put("];\n");
     n += 1;
   }
 
   // zero or one vertices corner case
   if (n < 2) {
-    stream << "}" << endl;
+    w.put("}\n");
     return;
   }
 
-  for (auto vd : g)
+  for (auto vd : g) {
+    int fst = g.index(vd);
     for (auto ed = vd->arcs; ed != g.last_edge(); ed = ed->next) {
-      int fst = indexes[vd];
-      int snd = indexes[ed->tip];
+      int snd = g.index(ed->tip);
       if (fst > snd)
         continue; // links are always symmetric
-      stream << "v" << fst << " -- "
-             << "v" << snd << "[" << ed->load << "]" << endl;
+      w.put('v');
+      w.put_uint(fst);
+      w.put(" -- v");
+      w.put_uint(snd);
+      w.put('[');
+      out_load(w, ed->load);
+      w.put("]\n");
     }
+  }
+
+  w.put("}\n");
+}
 
-  stream << "}" << endl;
+// writes "V<fst>V<snd>" (or just "V<fst>" for snd < 0) for mps
+static inline size_t out_mps_name(BufWriter &w, int fst, int snd = -1) {
+  size_t len = w.put('V') + w.put_uint(fst);
+  if (snd >= 0)
+    len += w.put('V') + w.put_uint(snd);
+  return len;
 }
 
 // mps format: https://en.wikipedia.org/wiki/MPS_(format)
 // useful for LP approximations
 template <typename G> void out_mps_to_stream(ostream &stream, G &g) {
-  using VD = typename G::VertexDescriptor;
-  stream << std::setw(14) << std::left << "NAME" << std::setw(0) << "BIPART"
-         << endl;
-  stream << "ROWS" << endl;
-  stream << std::setw(4) << std::left << " N" << std::setw(0) << "COST" << endl;
-
-  int n = 0;
-  map<VD, int> indexes;
-  set<pair<int, int>> proper_edges;
-
-  for (auto vd : g)
-    indexes[vd] = n++;
+  BufWriter w(stream);
+  w.put("NAME          BIPART\n");
+  w.put("ROWS\n");
+  w.put(" N  COST\n");
 
-  for (auto vd : g)
+  // proper edges in lexicographic order without duplicates:
+  // vertices come in index order, only neighbors are sorted
+  vector<pair<int, int>> proper_edges;
+  vector<int> nbs;
+  for (auto vd : g) {
+    int vidx = g.index(vd);
+    nbs.clear();
     for (auto ed = vd->arcs; ed != g.last_edge(); ed = ed->next)
-      if (indexes[vd] < indexes[ed->tip])
-        proper_edges.insert(make_pair(indexes[vd], indexes[ed->tip]));
+      if (vidx < g.index(ed->tip))
+        nbs.push_back(g.index(ed->tip));
+    std::sort(nbs.begin(), nbs.end());
+    nbs.erase(std::unique(nbs.begin(), nbs.end()), nbs.end());
+    for (auto nb : nbs)
+      proper_edges.emplace_back(vidx, nb);
+  }
 
-  for (auto pe : proper_edges)
-    stream << std::setw(4) << std::left << " G" << std::setw(0) << "V"
-           << pe.first << std::setw(0) << "V" << pe.second << endl;
+  for (auto pe : proper_edges) {
+    w.put(" G  ");
+    out_mps_name(w, pe.first, pe.second);
+    w.put('\n');
+  }
 
-  stream << "COLUMNS" << endl;
+  w.put("COLUMNS\n");
   for (auto vd : g) {
-    int vidx = indexes[vd];
-    string vstr = string("V") + to_string(vidx);
-    stream << std::setw(4) << " " << std::setw(10) << std::left << vstr
-           << std::setw(20) << std::left << "COST" << std::setw(0) << "1"
-           << endl;
+    int vidx = g.index(vd);
+    w.put("    ");
+    w.pad(out_mps_name(w, vidx), 10);
+    w.put("COST                1\n");
 
     for (auto ed = vd->arcs; ed != g.last_edge(); ed = ed->next) {
-      int iless = indexes[ed->tip];
+      int iless = g.index(ed->tip);
       int ibigger = vidx;
       if (iless > ibigger)
         std::swap(iless, ibigger);
-      string estr =
-          string("V") + to_string(iless) + string("V") + to_string(ibigger);
-      stream << std::setw(4) << " " << std::setw(10) << std::left << vstr
-             << std::setw(20) << std::left << estr << std::setw(0) << "1"
-             << endl;
+      w.put("    ");
+      w.pad(out_mps_name(w, vidx), 10);
+      w.pad(out_mps_name(w, iless, ibigger), 20);
+      w.put("1\n");
     }
   }
 
-  stream << "RHS" << endl;
+  w.put("RHS\n");
   for (auto pe : proper_edges) {
-    string estr =
-        string("V") + to_string(pe.first) + string("V") + to_string(pe.second);
-    stream << std::setw(4) << " " << std::setw(10) << std::left << "RHS1"
-           << std::setw(20) << std::left << estr << std::setw(0) << "1" << endl;
+    w.put("    RHS1      ");
+    w.pad(out_mps_name(w, pe.first, pe.second), 20);
+    w.put("1\n");
   }
 
-  stream << "BOUNDS" << endl;
+  w.put("BOUNDS\n");
   for (auto vd : g) {
-    string vstr = string("V") + to_string(indexes[vd]);
+    w.put(" LO BND1      ");
+    w.pad(out_mps_name(w, g.index(vd)), 20);
+    w.put("0\n");
+  }
+  w.put("ENDATA\n");
+}
+
+//------------------------------------------------------------------------------
+//
+//  Integer formats: vertex ids are 1-based integers, no names
+//
+//------------------------------------------------------------------------------
 
-    stream << std::setw(4) << " LO" << std::setw(10) << std::left << "BND1"
-           << std::setw(20) << std::left << vstr << std::setw(0) << "0" << endl;
+template <typename G> int count_edges(G &g) {
+  int narcs = 0;
+  for (auto vd : g)
+    for (auto ed = vd->arcs; ed != g.last_edge(); ed = ed->next)
+      narcs += 1;
+  return narcs / 2;
+}
+
+// calls callback(fst, snd) for every edge once, fst < snd, 1-based
+template <typename G, typename C> void for_each_edge_1based(G &g, C callback) {
+  for (auto vd : g) {
+    int fst = g.index(vd) + 1;
+    for (auto ed = vd->arcs; ed != g.last_edge(); ed = ed->next) {
+      int snd = g.index(ed->tip) + 1;
+      if (fst < snd)
+        callback(fst, snd);
+    }
+  }
+}
+
+// PACE 2019 vertex cover track: https://pacechallenge.org/2019/vc/
+// header "p td n m" then "u v" per edge
+template <typename G> void out_pace_to_stream(ostream &stream, G &g) {
+  BufWriter w(stream);
+  w.put("p td ");
+  w.put_uint(g.nvertices());
+  w.put(' ');
+  w.put_uint(count_edges(g));
+  w.put('\n');
+  for_each_edge_1based(g, [&w](int fst, int snd) {
+    w.put_uint(fst);
+    w.put(' ');
+    w.put_uint(snd);
+    w.put('\n');
+  });
+}
+
+// DIMACS: header "p edge n m" then "e u v" per edge
+template <typename G> void out_dimacs_to_stream(ostream &stream, G &g) {
+  BufWriter w(stream);
+  w.put("p edge ");
+  w.put_uint(g.nvertices());
+  w.put(' ');
+  w.put_uint(count_edges(g));
+  w.put('\n');
+  for_each_edge_1based(g, [&w](int fst, int snd) {
+    w.put("e ");
+    w.put_uint(fst);
+    w.put(' ');
+    w.put_uint(snd);
+    w.put('\n');
+  });
+}
+
+// METIS: header "n m" then line i lists all neighbors of vertex i
+template <typename G> void out_metis_to_stream(ostream &stream, G &g) {
+  BufWriter w(stream);
+  w.put_uint(g.nvertices());
+  w.put(' ');
+  w.put_uint(count_edges(g));
+  w.put('\n');
+  for (auto vd : g) {
+    bool first = true;
+    for (auto ed = vd->arcs; ed != g.last_edge(); ed = ed->next) {
+      if (!first)
+        w.put(' ');
+      w.put_uint(g.index(ed->tip) + 1);
+      first = false;
+    }
+    w.put('\n');
+  }
+}
+
+// PACE solution: header "s vc n k" then k lines with cover vertices
+// callback in_cover(vd) shall return true for vertices in cover
+template <typename G, typename C>
+void out_pace_vc_to_stream(ostream &stream, G &g, C in_cover) {
+  BufWriter w(stream);
+  int k = 0;
+  for (auto vd : g)
+    if (in_cover(vd))
+      k += 1;
+
+  w.put("s vc ");
+  w.put_uint(g.nvertices());
+  w.put(' ');
+  w.put_uint(k);
+  w.put('\n');
+  int n = 0;
+  for (auto vd : g) {
+    n += 1;
+    if (in_cover(vd)) {
+      w.put_uint(n);
+      w.put('\n');
+    }
   }
-  stream << "ENDATA" << endl;
 }
 
 //===----------------------------------------------------------------------===//
@@ -139,7 +353,7 @@ template <typename G> void read_graph_from_stream(istream &stream, G &g) {
   string line;
   int vidx = 0;
   map<string, int> vertices;
-  map<int, set<int>> edges;
+  vector<pair<int, int>> edges;
 
   while (getline(stream, line)) {
     size_t found = line.find(" ");
@@ -150,17 +364,244 @@ template <typename G> void read_graph_from_stream(istream &stream, G &g) {
     int rnum = update_vertices(rhs, vertices, vidx);
     if (lnum > rnum)
       std::swap(lnum, rnum);
-    if (edges.find(lnum) == edges.end()) {
-      set<int> s{rnum};
-      edges[lnum] = s;
-    } else
-      edges[lnum].insert(rnum);
+    edges.emplace_back(lnum, rnum);
   }
 
+  // repeated pairs merged, links come in ascending order
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
   g.add_isolated(vidx);
-  for (auto v1 : edges)
-    for (auto v2 : v1.second)
-      g.add_link(v1.first, v2);
+  for (auto e : edges)
+    g.add_link(e.first, e.second);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Integer formats: no string interning, input is parsed in big chunks
+//
+//------------------------------------------------------------------------------
+
+// chunked reader directly from stream buffer
+// no per-line or per-token allocations
+class IntReader final {
+  std::streambuf *sb_;
+  vector<char> buf_;
+  const char *cur_ = nullptr;
+  const char *end_ = nullptr;
+  bool refill();
+
+public:
+  explicit IntReader(istream &stream, size_t bufsize = 1 << 16)
+      : sb_(stream.rdbuf()), buf_(bufsize) {}
+
+  // next char, -1 at end of input
+  int peek() {
+    return (cur_ != end_ || refill()) ? (unsigned char)*cur_ : -1;
+  }
+  void skip() { ++cur_; }
+
+  // skip spaces, tabs and carriage returns, stops at newline
+  void skip_blanks() {
+    for (int c = peek(); c == ' ' || c == '\t' || c == '\r'; c = peek())
+      skip();
+  }
+
+  // skip everything up to and including newline
+  void skip_line() {
+    for (int c = peek(); c != -1; c = peek()) {
+      skip();
+      if (c == '\n')
+        return;
+    }
+  }
+
+  // skip non-blank word, like "td" in PACE header
+  void skip_word() {
+    skip_blanks();
+    for (int c = peek(); c > ' '; c = peek())
+      skip();
+  }
+
+  // false if no digits before end of line
+  bool read_uint(unsigned &res) {
+    skip_blanks();
+    int c = peek();
+    if (c < '0' || c > '9')
+      return false;
+    res = 0;
+    for (; c >= '0' && c <= '9'; c = peek()) {
+      res = res * 10 + (c - '0');
+      skip();
+    }
+    return true;
+  }
+};
+
+// edge list lines are "u v" or "e u v", ids as they are; lines starting
+// with anything else (comments, headers) are skipped
+template <typename F> size_t for_each_edge(istream &stream, F f) {
+  IntReader in(stream);
+  size_t cnt = 0;
+  unsigned u, v;
+  for (;;) {
+    in.skip_blanks();
+    int c = in.peek();
+    if (c == -1)
+      break;
+    if (c == 'e')
+      in.skip();
+    else if (c < '0' || c > '9') {
+      in.skip_line();
+      continue;
+    }
+    bool edge = in.read_uint(u) && in.read_uint(v);
+    assert(edge && "You must separate vertices with space(s)");
+    f(u, v);
+    cnt += 1;
+    in.skip_line();
+  }
+  return cnt;
+}
+
+// PACE 2019 .gr format
+// c comment
+// p td NVertices NEdges
+// u v (1-based)
+template <typename G> void read_pace_from_stream(istream &stream, G &g) {
+  g.cleanup();
+  IntReader in(stream);
+  unsigned n = 0, m = 0, u, v;
+  bool header = false;
+
+  for (;;) {
+    in.skip_blanks();
+    int c = in.peek();
+    if (c == -1)
+      break;
+    if (c == 'c' || c == '\n') {
+      in.skip_line();
+      continue;
+    }
+    if (c == 'p') {
+      in.skip();
+      in.skip_word();
+      header = in.read_uint(n) && in.read_uint(m);
+      assert(header && "PACE header is p td NVertices NEdges");
+      g.add_isolated(n);
+      in.skip_line();
+      continue;
+    }
+    assert(header && "PACE edges shall follow p-line");
+    bool edge = in.read_uint(u) && in.read_uint(v);
+    assert(edge && "You must separate vertices with space(s)");
+    assert(u >= 1 && u <= n && v >= 1 && v <= n && "Vertex id out of range");
+    g.add_link(u - 1, v - 1);
+    in.skip_line();
+  }
+}
+
+// DIMACS "p edge" format
+// c comment
+// p edge NVertices NEdges
+// e u v (1-based)
+// some DIMACS files list both u v and v u, so edges are deduplicated
+template <typename G> void read_dimacs_from_stream(istream &stream, G &g) {
+  g.cleanup();
+  IntReader in(stream);
+  unsigned n = 0, m = 0, u, v;
+  bool header = false;
+  vector<pair<unsigned, unsigned>> edges;
+
+  for (;;) {
+    in.skip_blanks();
+    int c = in.peek();
+    if (c == -1)
+      break;
+    if (c == 'p') {
+      in.skip();
+      in.skip_word();
+      header = in.read_uint(n) && in.read_uint(m);
+      assert(header && "DIMACS header is p edge NVertices NEdges");
+      edges.reserve(m);
+    } else if (c == 'e') {
+      in.skip();
+      assert(header && "DIMACS edges shall follow p-line");
+      bool edge = in.read_uint(u) && in.read_uint(v);
+      assert(edge && "DIMACS edge is e u v");
+      assert(u >= 1 && u <= n && v >= 1 && v <= n && "Vertex id out of range");
+      if (u > v)
+        std::swap(u, v);
+      edges.emplace_back(u - 1, v - 1);
+    }
+    // comments and all other lines (like n for weights) ignored
+    in.skip_line();
+  }
+
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  g.add_isolated(n);
+  for (auto e : edges)
+    g.add_link(e.first, e.second);
+}
+
+// METIS format
+// % comment
+// NVertices NEdges [fmt [ncon]]
+// line i: [size] [ncon weights] neighbor [weight] neighbor [weight] ...
+// every edge is listed twice, weights are skipped
+template <typename G> void read_metis_from_stream(istream &stream, G &g) {
+  g.cleanup();
+  IntReader in(stream);
+  unsigned n = 0, m = 0, fmt = 0, ncon = 1, skipped, u;
+
+  // header
+  for (;;) {
+    in.skip_blanks();
+    int c = in.peek();
+    assert(c != -1 && "METIS header expected");
+    if (c == '%' || c == '\n') {
+      in.skip_line();
+      continue;
+    }
+    bool header = in.read_uint(n) && in.read_uint(m);
+    assert(header && "METIS header is NVertices NEdges [fmt [ncon]]");
+    if (in.read_uint(fmt))
+      in.read_uint(ncon);
+    in.skip_line();
+    break;
+  }
+
+  bool has_ewgt = (fmt % 10) != 0;
+  bool has_vwgt = ((fmt / 10) % 10) != 0;
+  bool has_vsize = ((fmt / 100) % 10) != 0;
+
+  g.add_isolated(n);
+  unsigned vidx = 0;
+  while (vidx < n) {
+    int c = in.peek();
+    if (c == -1)
+      break;
+    if (c == '%') {
+      in.skip_line();
+      continue;
+    }
+    if (has_vsize)
+      in.read_uint(skipped);
+    if (has_vwgt)
+      for (unsigned w = 0; w != ncon; ++w)
+        in.read_uint(skipped);
+    while (in.read_uint(u)) {
+      assert(u >= 1 && u <= n && "Vertex id out of range");
+      if (vidx < u - 1)
+        g.add_link(vidx, u - 1);
+      if (has_ewgt)
+        in.read_uint(skipped);
+    }
+    in.skip_line();
+    vidx += 1;
+  }
 }
 
 #endif
@@ -10,16 +10,27 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <forward_list>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -28,17 +39,29 @@ using std::cout;
 using std::endl;
 using std::forward_list;
 using std::getline;
+using std::istringstream;
 using std::ifstream;
 using std::istream;
 using std::map;
 using std::ofstream;
 using std::ostream;
+using std::ostringstream;
 using std::list;
 using std::make_pair;
 using std::pair;
 using std::set;
 using std::string;
 using std::to_string;
+using std::unordered_map;
 using std::vector;
 
+namespace KGR {
+
+// nthreads == 0 means hardware concurrency
+inline int thread_count(int nthreads) {
+  return (nthreads > 0) ? nthreads
+                        : std::max(1u, std::thread::hardware_concurrency());
+}
+}
+
 #endif
@@ -0,0 +1,110 @@
+//===-- KGMapped.cpp -- memory-mapped graph supplement --------------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGMapped.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace KGR {
+
+const char mapped_magic[8] = {'K', 'G', 'M', 'A', 'P', '0', '2', '\0'};
+
+MappedFile::MappedFile(MappedFile &&rhs) noexcept
+    : addr_(rhs.addr_), size_(rhs.size_) {
+  rhs.addr_ = nullptr;
+  rhs.size_ = 0;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&rhs) noexcept {
+  if (this != &rhs) {
+    unmap();
+    std::swap(addr_, rhs.addr_);
+    std::swap(size_, rhs.size_);
+  }
+  return *this;
+}
+
+// empty file is mapped as empty range: mmap rejects zero length
+bool MappedFile::map(const char *path, bool writable) {
+  unmap();
+  int fd = ::open(path, writable ? O_RDWR : O_RDONLY);
+  if (fd == -1)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    ::close(fd);
+    return false;
+  }
+  size_t size = st.st_size;
+  if (size != 0) {
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void *addr = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+      ::close(fd);
+      return false;
+    }
+    addr_ = static_cast<char *>(addr);
+  }
+  // mapping keeps file referenced
+  ::close(fd);
+  size_ = size;
+  return true;
+}
+
+void MappedFile::unmap() {
+  if (addr_)
+    munmap(addr_, size_);
+  addr_ = nullptr;
+  size_ = 0;
+}
+
+void MappedFile::advise(MapAccess how) {
+  if (!addr_)
+    return;
+  int advice = MADV_NORMAL;
+  if (how == MapAccess::sequential)
+    advice = MADV_SEQUENTIAL;
+  else if (how == MapAccess::random)
+    advice = MADV_RANDOM;
+  madvise(addr_, size_, advice);
+}
+
+void MappedFile::flush() {
+  if (addr_)
+    msync(addr_, size_, MS_SYNC);
+}
+
+bool MappedFile::create(const char *path, size_t size) {
+  int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1)
+    return false;
+  bool ok = (ftruncate(fd, size) == 0);
+  ::close(fd);
+  return ok;
+}
+
+bool MappedFile::resize(const char *path, size_t size) {
+  return truncate(path, size) == 0;
+}
+
+// rows only shrink, so compacted row never overtakes rows not yet visited
+uint64_t compact_rows(uint64_t n, uint64_t *offsets, int32_t *targets) {
+  uint64_t out = 0;
+  for (uint64_t v = 0; v != n; ++v) {
+    int32_t *fst = targets + offsets[v], *lst = targets + offsets[v + 1];
+    std::sort(fst, lst);
+    lst = std::unique(fst, lst);
+    offsets[v] = out;
+    out = std::copy(fst, lst, targets + out) - targets;
+  }
+  offsets[n] = out;
+  return out;
+}
+}
@@ -0,0 +1,398 @@
+//===-- KGMapped.hpp -- out-of-core graph in memory-mapped files ----------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// MappedFile -- whole file mapped with mmap, unmapped in destructor
+//
+// MappedGraph -- read-only CSR topology plus writable vertex and edge loads,
+//                all in mapped files, so graph may exceed RAM: pages are
+//                read by kernel on demand and evicted under pressure
+//
+// Files for base path P, written once by MappedGraph::write or build:
+//   P    -- header, then offsets (uint64 per vertex, n + 1), then targets
+//           (int32 per arc); 64-bit offsets allow more than 2^32 arcs
+//   P.vl -- vertex loads, raw VL per vertex
+//   P.el -- edge loads, raw EL per arc, same order as targets
+// Rows are sorted, parallel edges merged and self-loops dropped, so arcs
+// are what VCWorkspace::load_csr expects. Loads must be trivially copyable;
+// they are mapped shared, so per-vertex state written by algorithms is
+// persistent.
+//
+// write streams over graph already in memory; build takes edges from
+// edge source or edge list file in two passes and keeps only O(n)
+// counters in memory, arcs go straight to mapped topology file.
+//
+// Files hold more than 2^31 arcs, but consumers do not: VCWorkspace keeps
+// int arc indices and per-vertex state in RAM, so load_csr refuses such
+// graphs, and KGAlg.hpp algorithms keep per-vertex vectors too.
+//
+// Same handle descriptors as Graph: algorithms from KGAlg.hpp stream over
+// rows in vertex order, which with default sequential advice is read-ahead
+// friendly. Use MapAccess::random for search-heavy phases.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KMAPPED_GUARD__
+#define GRAPH_KMAPPED_GUARD__
+
+#include "KGraph.hpp"
+
+#include <type_traits>
+
+namespace KGR {
+
+enum class MapAccess { normal, sequential, random };
+
+class MappedFile final {
+  char *addr_ = nullptr;
+  size_t size_ = 0;
+
+public:
+  MappedFile() = default;
+  ~MappedFile() { unmap(); }
+  MappedFile(MappedFile &&rhs) noexcept;
+  MappedFile &operator=(MappedFile &&rhs) noexcept;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // false if file can not be opened or mapped
+  bool map(const char *path, bool writable);
+  void unmap();
+  void advise(MapAccess how);
+
+  // writes dirty pages back to file
+  void flush();
+
+  // new file of given size, zero filled
+  static bool create(const char *path, size_t size);
+
+  // cuts or extends file; shall not be mapped when cut, mapping of file
+  // that only grows stays valid
+  static bool resize(const char *path, size_t size);
+
+  char *data() const { return addr_; }
+  size_t size() const { return size_; }
+};
+
+struct MappedHeader {
+  char magic[8];
+  uint64_t n, narcs;
+};
+
+extern const char mapped_magic[8];
+
+// rows of CSR in place: sorted, repeats merged, compacted to the left;
+// offsets rewritten, returns number of arcs left
+uint64_t compact_rows(uint64_t n, uint64_t *offsets, int32_t *targets);
+
+template <typename VL, typename EL> class MappedGraph final {
+  static_assert(std::is_trivially_copyable<VL>::value &&
+                    std::is_trivially_copyable<EL>::value,
+                "Mapped loads are raw bytes");
+
+  MappedFile topo_, vfile_, efile_;
+  int n_ = 0;
+  uint64_t narcs_ = 0;
+  const uint64_t *offsets_ = nullptr;
+  const int32_t *targets_ = nullptr;
+  VL *vloads_ = nullptr;
+  EL *eloads_ = nullptr;
+
+  static bool put(ofstream &ofs, const void *data, size_t size) {
+    return size == 0 ||
+           (bool)ofs.write(static_cast<const char *>(data), size);
+  }
+
+  // default loads for vertices and arcs of built topology
+  static bool put_default_loads(const string &base, uint64_t n,
+                                uint64_t narcs) {
+    ofstream vls(base + ".vl", std::ios::binary),
+        els(base + ".el", std::ios::binary);
+    const uint64_t chunk = 1 << 16;
+    vector<VL> vl(std::min(n, chunk));
+    vector<EL> el(std::min(narcs, chunk));
+    for (uint64_t done = 0; vls && done != n; done += vl.size()) {
+      vl.resize(std::min(n - done, chunk));
+      put(vls, vl.data(), vl.size() * sizeof(VL));
+    }
+    for (uint64_t done = 0; els && done != narcs; done += el.size()) {
+      el.resize(std::min(narcs - done, chunk));
+      put(els, el.data(), el.size() * sizeof(EL));
+    }
+    return vls && els;
+  }
+
+  static size_t topology_size(uint64_t n, uint64_t narcs) {
+    return sizeof(MappedHeader) + (n + 1) * sizeof(uint64_t) +
+           narcs * sizeof(int32_t);
+  }
+
+public:
+  struct ArcPos {
+    uint64_t pos, end;
+    friend bool operator==(ArcPos lhs, ArcPos rhs) {
+      return lhs.pos == rhs.pos;
+    }
+  };
+
+  // storage interface for handles
+public:
+  using VLoad = VL;
+  using ELoad = EL;
+  VL &vload(uint32_t v) { return vloads_[v]; }
+  EL &eload(ArcPos a) { return eloads_[a.pos]; }
+  ArcPos first_arc(uint32_t v) {
+    uint64_t fst = offsets_[v], lst = offsets_[v + 1];
+    return (fst == lst) ? nil_arc() : ArcPos{fst, lst};
+  }
+  ArcPos next_arc(ArcPos a) {
+    return (a.pos + 1 == a.end) ? nil_arc() : ArcPos{a.pos + 1, a.end};
+  }
+  uint32_t arc_tip(ArcPos a) { return targets_[a.pos]; }
+  static ArcPos nil_arc() {
+    return {std::numeric_limits<uint64_t>::max(),
+            std::numeric_limits<uint64_t>::max()};
+  }
+
+public:
+  MappedGraph() = default;
+  MappedGraph(const MappedGraph &) = delete;
+  MappedGraph &operator=(const MappedGraph &) = delete;
+
+  // writes files for path, streaming over g row by row; offsets are
+  // known only at the end, so they are written last over placeholder
+  template <typename G> static bool write(const char *path, G &g) {
+    string base(path);
+    ofstream topo(base, std::ios::binary), vls(base + ".vl", std::ios::binary),
+        els(base + ".el", std::ios::binary);
+    if (!topo || !vls || !els)
+      return false;
+
+    MappedHeader hdr;
+    std::copy(mapped_magic, mapped_magic + 8, hdr.magic);
+    hdr.n = g.nvertices();
+    hdr.narcs = 0;
+    vector<uint64_t> offsets{0};
+    offsets.reserve(hdr.n + 1);
+    topo.seekp(topology_size(hdr.n, 0));
+
+    vector<pair<int32_t, EL>> row;
+    vector<int32_t> tips;
+    vector<EL> loads;
+    for (auto vd : g) {
+      VL vl = vd->load;
+      put(vls, &vl, sizeof(VL));
+      row.clear();
+      for (auto ed = vd->arcs; ed != g.last_edge(); ed = ed->next)
+        if (ed->tip != vd)
+          row.emplace_back(g.index(ed->tip), ed->load);
+      // stable: first of parallel edges keeps its load
+      std::stable_sort(row.begin(), row.end(),
+                       [](const pair<int32_t, EL> &lhs,
+                          const pair<int32_t, EL> &rhs) {
+                         return lhs.first < rhs.first;
+                       });
+      tips.clear();
+      loads.clear();
+      for (auto &a : row)
+        if (tips.empty() || tips.back() != a.first) {
+          tips.push_back(a.first);
+          loads.push_back(a.second);
+        }
+      put(topo, tips.data(), tips.size() * sizeof(int32_t));
+      put(els, loads.data(), loads.size() * sizeof(EL));
+      offsets.push_back(offsets.back() + tips.size());
+    }
+
+    hdr.narcs = offsets.back();
+    topo.seekp(0);
+    put(topo, &hdr, sizeof(hdr));
+    put(topo, offsets.data(), offsets.size() * sizeof(uint64_t));
+    return topo && vls && els;
+  }
+
+  // builds files for path from edge source with default loads
+  // edges(f) shall call f(u, v) for every edge, same edges on both calls:
+  // first pass counts degrees, second one scatters arcs into mapped file
+  // n is at least max id + 1; loops are dropped
+  template <typename E>
+  static bool build(const char *path, E edges, uint64_t n = 0) {
+    vector<uint64_t> fill(n, 0);
+    edges([&fill](unsigned u, unsigned v) {
+      if (u == v)
+        return;
+      uint64_t top = std::max(u, v);
+      assert(top < (uint64_t)std::numeric_limits<int32_t>::max());
+      if (top >= fill.size())
+        fill.resize(top + 1, 0);
+      fill[u] += 1;
+      fill[v] += 1;
+    });
+    n = fill.size();
+    uint64_t total = 0;
+    for (auto &f : fill) {
+      uint64_t deg = f;
+      f = total;
+      total += deg;
+    }
+
+    if (!MappedFile::create(path, topology_size(n, total)))
+      return false;
+    MappedFile topo;
+    if (!topo.map(path, true))
+      return false;
+    auto *hdr = reinterpret_cast<MappedHeader *>(topo.data());
+    auto *offsets = reinterpret_cast<uint64_t *>(hdr + 1);
+    auto *targets = reinterpret_cast<int32_t *>(offsets + n + 1);
+    std::copy(fill.begin(), fill.end(), offsets);
+    offsets[n] = total;
+
+    bool same = true;
+    edges([&](unsigned u, unsigned v) {
+      if (u == v)
+        return;
+      if (std::max(u, v) >= n || fill[u] == offsets[u + 1] ||
+          fill[v] == offsets[v + 1]) {
+        same = false;
+        return;
+      }
+      targets[fill[u]++] = v;
+      targets[fill[v]++] = u;
+    });
+    for (uint64_t v = 0; v != n; ++v)
+      same = same && (fill[v] == offsets[v + 1]);
+    if (!same)
+      return false;
+
+    uint64_t narcs = compact_rows(n, offsets, targets);
+    std::copy(mapped_magic, mapped_magic + 8, hdr->magic);
+    hdr->n = n;
+    hdr->narcs = narcs;
+    topo.unmap();
+    return MappedFile::resize(path, topology_size(n, narcs)) &&
+           put_default_loads(path, n, narcs);
+  }
+
+  // builds files for path from edge list file, see for_each_edge
+  static bool build(const char *path, const char *edge_path, uint64_t n = 0) {
+    bool opened = true;
+    auto edges = [edge_path, &opened](auto f) {
+      ifstream ifs(edge_path);
+      opened = opened && ifs.is_open();
+      for_each_edge(ifs, f);
+    };
+    return build(path, edges, n) && opened;
+  }
+
+  // maps files of path, previous ones are unmapped
+  bool open(const char *path) {
+    close();
+    string base(path);
+    if (!topo_.map(path, false) || topo_.size() < sizeof(MappedHeader))
+      return false;
+    MappedHeader hdr;
+    std::copy(topo_.data(), topo_.data() + sizeof(hdr),
+              reinterpret_cast<char *>(&hdr));
+    if (!std::equal(mapped_magic, mapped_magic + 8, hdr.magic) ||
+        hdr.n >= (uint64_t)std::numeric_limits<int>::max() ||
+        topo_.size() != topology_size(hdr.n, hdr.narcs)) {
+      close();
+      return false;
+    }
+    n_ = hdr.n;
+    narcs_ = hdr.narcs;
+    offsets_ = reinterpret_cast<const uint64_t *>(topo_.data() + sizeof(hdr));
+    targets_ = reinterpret_cast<const int32_t *>(offsets_ + n_ + 1);
+
+    if (!vfile_.map((base + ".vl").c_str(), true) ||
+        !efile_.map((base + ".el").c_str(), true) ||
+        vfile_.size() != n_ * sizeof(VL) ||
+        efile_.size() != narcs_ * sizeof(EL)) {
+      close();
+      return false;
+    }
+    vloads_ = reinterpret_cast<VL *>(vfile_.data());
+    eloads_ = reinterpret_cast<EL *>(efile_.data());
+    advise(MapAccess::sequential);
+    return true;
+  }
+
+  void close() {
+    topo_.unmap();
+    vfile_.unmap();
+    efile_.unmap();
+    n_ = 0;
+    narcs_ = 0;
+    offsets_ = nullptr;
+    targets_ = nullptr;
+    vloads_ = nullptr;
+    eloads_ = nullptr;
+  }
+
+  void advise(MapAccess how) {
+    topo_.advise(how);
+    vfile_.advise(how);
+    efile_.advise(how);
+  }
+
+  // loads are written back by kernel anyway, this forces it now
+  void flush() {
+    vfile_.flush();
+    efile_.flush();
+  }
+
+  // raw CSR for VCWorkspace::load_csr
+  const uint64_t *offsets() const { return offsets_; }
+  const int *targets() const { return targets_; }
+
+  // general interface
+public:
+  using VertexDescriptor = VertexHandle<MappedGraph>;
+  using EdgeDescriptor = EdgeHandle<MappedGraph>;
+  using VertexIterator = IndexIterator<MappedGraph>;
+  const char *name() const { return "G"; }
+  int nvertices() { return n_; }
+  uint64_t narcs() { return narcs_; }
+  VertexDescriptor front() { return vertex(0); }
+  VertexDescriptor back() { return vertex(n_ - 1); }
+  VertexIterator begin() { return VertexIterator(this, 0); }
+  VertexIterator end() { return VertexIterator(this, n_); }
+  VertexDescriptor last_vertex() { return VertexDescriptor(); }
+  EdgeDescriptor last_edge() { return EdgeDescriptor(this, nil_arc()); }
+  int index(VertexDescriptor vd) { return vd.index(); }
+  VertexDescriptor vertex(int i) {
+    assert(i >= 0 && i < n_);
+    return VertexDescriptor(this, i);
+  }
+
+  // rows are sorted: binary search
+  EdgeDescriptor get_edge(VertexDescriptor u, VertexDescriptor v) {
+    assert(u != last_vertex() && v != last_vertex());
+    uint64_t fst = offsets_[u.index()], lst = offsets_[u.index() + 1];
+    auto it = std::lower_bound(targets_ + fst, targets_ + lst,
+                               (int32_t)v.index());
+    if (it == targets_ + lst || *it != (int32_t)v.index())
+      return last_edge();
+    return EdgeDescriptor(this, ArcPos{(uint64_t)(it - targets_), lst});
+  }
+  EdgeDescriptor get_sibling(EdgeDescriptor e, VertexDescriptor u) {
+    assert(e != last_edge() && u != last_vertex());
+    return get_edge(e->tip, u);
+  }
+  int degree(VertexDescriptor u) {
+    return offsets_[u.index() + 1] - offsets_[u.index()];
+  }
+
+  friend ostream &operator<<(ostream &stream, MappedGraph &g) {
+    out_dot_to_stream(stream, g);
+    return stream;
+  }
+};
+}
+
+#endif
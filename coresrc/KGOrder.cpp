@@ -0,0 +1,252 @@
+//===-- KGOrder.cpp -- vertex relabeling supplement -----------------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGOrder.hpp"
+
+#include <cmath>
+#include <queue>
+
+namespace KGR {
+
+const char *order_name(VertexOrder how) {
+  switch (how) {
+  default:
+    return "natural";
+  case VertexOrder::degree:
+    return "degree";
+  case VertexOrder::bfs:
+    return "bfs";
+  case VertexOrder::rcm:
+    return "rcm";
+  case VertexOrder::gorder:
+    return "gorder";
+  }
+}
+
+Adjacency make_adjacency(const VCProblem &p) {
+  Adjacency adj;
+  adj.offsets.assign(p.n + 1, 0);
+  for (auto e : p.edges) {
+    adj.offsets[e.first] += 1;
+    adj.offsets[e.second] += 1;
+  }
+  // prefix sums give ends of ranges, backward fill moves them to starts
+  int sum = 0;
+  for (auto &o : adj.offsets) {
+    sum += o;
+    o = sum;
+  }
+  adj.targets.resize(sum);
+  for (auto it = p.edges.rbegin(); it != p.edges.rend(); ++it) {
+    adj.targets[--adj.offsets[it->first]] = it->second;
+    adj.targets[--adj.offsets[it->second]] = it->first;
+  }
+  return adj;
+}
+
+// George-Liu: start from end of longest BFS, while eccentricity grows
+static int pseudo_peripheral(const Adjacency &adj, int start,
+                             vector<int> &dist) {
+  vector<int> touched;
+  int ecc = -1;
+  for (int iter = 0; iter != 4; ++iter) {
+    touched.clear();
+    dist[start] = 0;
+    touched.push_back(start);
+    for (size_t qpos = 0; qpos != touched.size(); ++qpos) {
+      int u = touched[qpos];
+      for (int a = adj.offsets[u]; a != adj.offsets[u + 1]; ++a)
+        if (dist[adj.targets[a]] == -1) {
+          dist[adj.targets[a]] = dist[u] + 1;
+          touched.push_back(adj.targets[a]);
+        }
+    }
+
+    int depth = dist[touched.back()];
+    int next = touched.back();
+    for (auto v : touched)
+      if (dist[v] == depth && adj.degree(v) < adj.degree(next))
+        next = v;
+    for (auto v : touched)
+      dist[v] = -1;
+
+    if (depth <= ecc)
+      break;
+    ecc = depth;
+    start = next;
+  }
+  return start;
+}
+
+// BFS over every component, starting from low-degree vertices
+// with sortnbs neighbors are queued in ascending degree (Cuthill-McKee)
+static vector<int> bfs_order(const Adjacency &adj, bool sortnbs) {
+  int n = adj.nvertices();
+  vector<int> order, starts(n), dist(n, -1);
+  vector<char> placed(n, 0);
+  order.reserve(n);
+
+  for (int v = 0; v != n; ++v)
+    starts[v] = v;
+  std::stable_sort(starts.begin(), starts.end(), [&adj](int u, int v) {
+    return adj.degree(u) < adj.degree(v);
+  });
+
+  for (auto s : starts) {
+    if (placed[s])
+      continue;
+    if (sortnbs)
+      s = pseudo_peripheral(adj, s, dist);
+    placed[s] = 1;
+    size_t qpos = order.size();
+    order.push_back(s);
+    for (; qpos != order.size(); ++qpos) {
+      int u = order[qpos];
+      size_t nbstart = order.size();
+      for (int a = adj.offsets[u]; a != adj.offsets[u + 1]; ++a)
+        if (!placed[adj.targets[a]]) {
+          placed[adj.targets[a]] = 1;
+          order.push_back(adj.targets[a]);
+        }
+      if (sortnbs)
+        std::stable_sort(order.begin() + nbstart, order.end(),
+                         [&adj](int x, int y) {
+                           return adj.degree(x) < adj.degree(y);
+                         });
+    }
+  }
+  return order;
+}
+
+static vector<int> degree_order(const Adjacency &adj) {
+  vector<int> order(adj.nvertices());
+  for (int v = 0; v != adj.nvertices(); ++v)
+    order[v] = v;
+  std::stable_sort(order.begin(), order.end(), [&adj](int u, int v) {
+    return adj.degree(u) > adj.degree(v);
+  });
+  return order;
+}
+
+// Gorder (Wei et al, 2016) for undirected graph with window of 5:
+// score of v is number of window vertices adjacent to v or sharing
+// neighbor with v; next vertex has maximal score. Lazy heap keeps
+// (score, vertex) pairs, stale ones are skipped on pop. Hubs do not
+// spread sibling score: it would cost deg^2 and carries no locality.
+static vector<int> gorder(const Adjacency &adj) {
+  const size_t window = 5;
+  int n = adj.nvertices();
+  int hub = std::max(16, (int)std::sqrt((double)n));
+  vector<int> order, score(n, 0), bydeg = degree_order(adj);
+  vector<char> placed(n, 0);
+  std::priority_queue<pair<int, int>> heap;
+  order.reserve(n);
+
+  auto bump = [&](int v, int delta) {
+    if (placed[v])
+      return;
+    score[v] += delta;
+    heap.emplace(score[v], v);
+  };
+
+  auto spread = [&](int u, int delta) {
+    for (int a = adj.offsets[u]; a != adj.offsets[u + 1]; ++a) {
+      int x = adj.targets[a];
+      bump(x, delta);
+      if (adj.degree(x) > hub)
+        continue;
+      for (int b = adj.offsets[x]; b != adj.offsets[x + 1]; ++b)
+        if (adj.targets[b] != u)
+          bump(adj.targets[b], delta);
+    }
+  };
+
+  size_t degpos = 0;
+  while ((int)order.size() != n) {
+    int next = -1;
+    while (!heap.empty() && next == -1) {
+      auto top = heap.top();
+      heap.pop();
+      if (!placed[top.second] && score[top.second] == top.first)
+        next = top.second;
+    }
+    if (next == -1) {
+      while (placed[bydeg[degpos]])
+        degpos += 1;
+      next = bydeg[degpos];
+    }
+
+    placed[next] = 1;
+    order.push_back(next);
+    spread(next, 1);
+    if (order.size() > window)
+      spread(order[order.size() - window - 1], -1);
+  }
+  return order;
+}
+
+vector<int> vertex_order(const Adjacency &adj, VertexOrder how) {
+  vector<int> order;
+  switch (how) {
+  case VertexOrder::natural:
+    order.resize(adj.nvertices());
+    for (int v = 0; v != adj.nvertices(); ++v)
+      order[v] = v;
+    break;
+  case VertexOrder::degree:
+    order = degree_order(adj);
+    break;
+  case VertexOrder::bfs:
+    order = bfs_order(adj, false);
+    break;
+  case VertexOrder::rcm:
+    order = bfs_order(adj, true);
+    std::reverse(order.begin(), order.end());
+    break;
+  case VertexOrder::gorder:
+    order = gorder(adj);
+    break;
+  }
+  assert((int)order.size() == adj.nvertices());
+  return order;
+}
+
+VCProblem relabel(const VCProblem &p, const vector<int> &order) {
+  assert((int)order.size() == p.n);
+  vector<int> pos(p.n);
+  for (int i = 0; i != p.n; ++i)
+    pos[order[i]] = i;
+
+  VCProblem res;
+  res.n = p.n;
+  res.edges.reserve(p.edges.size());
+  for (auto e : p.edges)
+    res.edges.emplace_back(pos[e.first], pos[e.second]);
+  return res;
+}
+
+OrderStats order_stats(const Adjacency &adj) {
+  OrderStats res;
+  long long nedges = 0;
+  double sumgap = 0, sumlog = 0;
+  for (int u = 0; u != adj.nvertices(); ++u)
+    for (int a = adj.offsets[u]; a != adj.offsets[u + 1]; ++a) {
+      int gap = adj.targets[a] - u;
+      if (gap <= 0)
+        continue; // every edge once, loops ignored
+      nedges += 1;
+      res.bandwidth = std::max(res.bandwidth, gap);
+      sumgap += gap;
+      sumlog += std::log2(gap + 1.0);
+    }
+  if (nedges > 0) {
+    res.avg_gap = sumgap / nedges;
+    res.avg_loggap = sumlog / nedges;
+  }
+  return res;
+}
+}
@@ -0,0 +1,84 @@
+//===-- KGOrder.hpp -- vertex relabeling for cache locality ---------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// Adjacency -- plain CSR snapshot of any graph, input for heuristics below
+//
+// vertex_order -- permutation order[new] = old, one of:
+//   natural  -- identity, first-seen order from readers
+//   degree   -- descending degree, hubs share cache lines
+//   bfs      -- breadth-first from min-degree vertex of each component
+//   rcm      -- reverse Cuthill-McKee, minimizes bandwidth
+//   gorder   -- greedy Gorder-like: next vertex has most neighbors and
+//               siblings among last placed ones
+//
+// relabel -- applies order to VCProblem, Graph takes order in constructor
+//
+// order_stats -- bandwidth and average log gap of arcs: how far neighbors
+//                are in memory, smaller is better
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KORDER_GUARD__
+#define GRAPH_KORDER_GUARD__
+
+#include "KGSolver.hpp"
+
+namespace KGR {
+
+enum class VertexOrder { natural, degree, bfs, rcm, gorder };
+
+const char *order_name(VertexOrder how);
+
+struct Adjacency {
+  vector<int> offsets{0}, targets;
+  int nvertices() const { return offsets.size() - 1; }
+  int degree(int v) const { return offsets[v + 1] - offsets[v]; }
+};
+
+// templates here take any graph, VertexDescriptor check keeps them
+// away from Adjacency and VCProblem overloads
+template <typename G, typename = typename G::VertexDescriptor>
+Adjacency make_adjacency(G &g) {
+  Adjacency adj;
+  adj.offsets.reserve(g.nvertices() + 1);
+  for (auto vd : g) {
+    for (auto ed = vd->arcs; ed != g.last_edge(); ed = ed->next)
+      adj.targets.push_back(g.index(ed->tip));
+    adj.offsets.push_back(adj.targets.size());
+  }
+  return adj;
+}
+
+Adjacency make_adjacency(const VCProblem &p);
+
+vector<int> vertex_order(const Adjacency &adj, VertexOrder how);
+
+template <typename G, typename = typename G::VertexDescriptor>
+vector<int> vertex_order(G &g, VertexOrder how) {
+  return vertex_order(make_adjacency(g), how);
+}
+
+// vertex order[i] of p becomes vertex i of result
+VCProblem relabel(const VCProblem &p, const vector<int> &order);
+
+struct OrderStats {
+  int bandwidth = 0;     // max |u - v| over edges
+  double avg_gap = 0;    // mean |u - v|
+  double avg_loggap = 0; // mean log2(|u - v| + 1), bits to encode gap
+};
+
+OrderStats order_stats(const Adjacency &adj);
+
+template <typename G, typename = typename G::VertexDescriptor>
+OrderStats order_stats(G &g) {
+  return order_stats(make_adjacency(g));
+}
+}
+
+#endif
@@ -0,0 +1,243 @@
+//===-- KGPacked.hpp -- read-only graph with compressed adjacency ---------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// PackedGraph -- frozen graph, neighbor lists sorted and gap-encoded
+//
+// Row of u is v0 < v1 < ... with parallel edges merged, stored as varints
+// (LEB128, 7 bits per byte, high bit means more bytes follow):
+//   degree, zigzag(v0 - u), v1 - v0 - 1, v2 - v1 - 1, ...
+// Gaps of well-ordered graphs (see KGOrder.hpp) mostly fit in one byte,
+// so arc costs 1-2 bytes instead of 4-byte tip of Graph or two heap Edge
+// nodes of GraphBuilder. Vertex costs one 4-byte offset of its row into
+// gap stream (plus one 4-byte arc number if EL is not empty type).
+//
+// Arcs are decoded on the fly: handle position carries current tip, arcs
+// left in row and byte offset of next gap, so next is one varint. Same
+// handle descriptors as Graph, algorithms from KGAlg.hpp work unchanged.
+// Edge loads and arc numbers of rows are kept only if EL is not empty type.
+//
+// Decoding is scalar: it is interleaved with per-arc work of algorithms
+// through handles, so there is no block of gaps to decode at once.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KPACKED_GUARD__
+#define GRAPH_KPACKED_GUARD__
+
+#include "KGraph.hpp"
+
+#include <type_traits>
+
+namespace KGR {
+
+template <typename VL, typename EL> class PackedGraph final {
+  vector<uint8_t> bytes_;
+  vector<uint32_t> boffs_; // n + 1 byte offsets of rows
+  vector<uint32_t> aoffs_; // n + 1 arc numbers of rows, empty for empty EL
+  vector<VL> vloads_;
+  vector<EL> eloads_; // empty for empty EL
+  uint32_t narcs_ = 0;
+  static EL empty_load_;
+
+  static constexpr bool has_eloads = !std::is_empty<EL>::value;
+
+  uint32_t get_varint(uint32_t &pos) const {
+    uint32_t x = bytes_[pos++];
+    if (x < 0x80)
+      return x;
+    x &= 0x7f;
+    for (int shift = 7;; shift += 7) {
+      uint32_t b = bytes_[pos++];
+      x |= (b & 0x7f) << shift;
+      if (b < 0x80)
+        return x;
+    }
+  }
+
+  void put_varint(uint32_t x) {
+    while (x >= 0x80) {
+      bytes_.push_back((x & 0x7f) | 0x80);
+      x >>= 7;
+    }
+    bytes_.push_back(x);
+  }
+
+  // row of u from ascending tips, first one is zigzag delta from u
+  template <typename C> void put_row(int u, int deg, C tipat) {
+    put_varint(deg);
+    for (int i = 0; i != deg; ++i) {
+      int d = tipat(i) - ((i == 0) ? u : tipat(i - 1) + 1);
+      if (i != 0)
+        put_varint(d);
+      else
+        put_varint(d < 0 ? (uint32_t(-d) << 1) - 1 : uint32_t(d) << 1);
+    }
+    narcs_ += deg;
+    assert(bytes_.size() < nil_index && "Packed rows exceed 4G bytes");
+    boffs_.push_back(bytes_.size());
+    if (has_eloads)
+      aoffs_.push_back(narcs_);
+  }
+
+public:
+  // byte offset of next gap is unique per arc, arc number is 0 for
+  // empty EL
+  struct ArcPos {
+    uint32_t pos, tip, left, arc;
+    friend bool operator==(ArcPos lhs, ArcPos rhs) {
+      return lhs.pos == rhs.pos;
+    }
+  };
+
+  // storage interface for handles
+public:
+  using VLoad = VL;
+  using ELoad = EL;
+  VL &vload(uint32_t v) { return vloads_[v]; }
+  EL &eload(ArcPos a) { return has_eloads ? eloads_[a.arc] : empty_load_; }
+  ArcPos first_arc(uint32_t v) {
+    uint32_t pos = boffs_[v];
+    uint32_t deg = get_varint(pos);
+    if (deg == 0)
+      return nil_arc();
+    uint32_t z = get_varint(pos);
+    uint32_t tip = (z & 1) ? v - ((z + 1) >> 1) : v + (z >> 1);
+    return ArcPos{pos, tip, deg - 1, has_eloads ? aoffs_[v] : 0};
+  }
+  ArcPos next_arc(ArcPos a) {
+    if (a.left == 0)
+      return nil_arc();
+    uint32_t pos = a.pos;
+    uint32_t tip = a.tip + get_varint(pos) + 1;
+    return ArcPos{pos, tip, a.left - 1, a.arc + has_eloads};
+  }
+  uint32_t arc_tip(ArcPos a) { return a.tip; }
+  static ArcPos nil_arc() { return {nil_index, nil_index, 0, 0}; }
+
+public:
+  PackedGraph() : boffs_(1, 0), aoffs_(has_eloads ? 1 : 0, 0) {}
+
+  // freeze mutable graph: same vertex order and loads, arcs sorted,
+  // first of parallel arcs keeps its load
+  explicit PackedGraph(GraphBuilder<VL, EL> &src) : PackedGraph() {
+    vector<pair<int, EL>> row;
+    vloads_.reserve(src.nvertices());
+    for (auto vd : src) {
+      int u = src.index(vd);
+      vloads_.push_back(vd->load);
+      row.clear();
+      for (auto ed = vd->arcs; ed != src.last_edge(); ed = ed->next)
+        row.emplace_back(src.index(ed->tip), ed->load);
+      std::stable_sort(
+          row.begin(), row.end(),
+          [](const pair<int, EL> &lhs, const pair<int, EL> &rhs) {
+            return lhs.first < rhs.first;
+          });
+      row.erase(std::unique(row.begin(), row.end(),
+                            [](const pair<int, EL> &lhs,
+                               const pair<int, EL> &rhs) {
+                              return lhs.first == rhs.first;
+                            }),
+                row.end());
+      put_row(u, row.size(), [&row](int i) { return row[i].first; });
+      if (has_eloads)
+        for (auto &a : row)
+          eloads_.push_back(a.second);
+    }
+  }
+
+  // from edge list, every edge becomes two arcs, default loads
+  PackedGraph(int n, const vector<pair<int, int>> &edges) : PackedGraph() {
+    vector<uint32_t> offsets(n + 1, 0);
+    for (auto e : edges) {
+      assert(e.first >= 0 && e.first < n);
+      assert(e.second >= 0 && e.second < n);
+      offsets[e.first + 1] += 1;
+      offsets[e.second + 1] += 1;
+    }
+    for (int v = 0; v != n; ++v)
+      offsets[v + 1] += offsets[v];
+    vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    vector<int> targets(offsets[n]);
+    for (auto e : edges) {
+      targets[fill[e.first]++] = e.second;
+      targets[fill[e.second]++] = e.first;
+    }
+
+    vloads_.assign(n, VL{});
+    for (int u = 0; u != n; ++u) {
+      auto first = targets.begin() + offsets[u];
+      auto last = targets.begin() + offsets[u + 1];
+      std::sort(first, last);
+      last = std::unique(first, last);
+      put_row(u, last - first, [first](int i) { return first[i]; });
+    }
+    if (has_eloads)
+      eloads_.assign(narcs_, EL{});
+  }
+
+  // general interface
+public:
+  using VertexDescriptor = VertexHandle<PackedGraph>;
+  using EdgeDescriptor = EdgeHandle<PackedGraph>;
+  using VertexIterator = IndexIterator<PackedGraph>;
+  const char *name() const { return "G"; }
+  int nvertices() { return vloads_.size(); }
+  int narcs() { return narcs_; }
+  VertexDescriptor front() { return vertex(0); }
+  VertexDescriptor back() { return vertex(nvertices() - 1); }
+  VertexIterator begin() { return VertexIterator(this, 0); }
+  VertexIterator end() { return VertexIterator(this, nvertices()); }
+  VertexDescriptor last_vertex() { return VertexDescriptor(); }
+  EdgeDescriptor last_edge() { return EdgeDescriptor(this, nil_arc()); }
+  int index(VertexDescriptor vd) { return vd.index(); }
+  VertexDescriptor vertex(int i) {
+    assert(i >= 0 && i < nvertices());
+    return VertexDescriptor(this, i);
+  }
+
+  // rows are sorted: decoding stops at first tip not below v
+  EdgeDescriptor get_edge(VertexDescriptor u, VertexDescriptor v) {
+    assert(u != last_vertex() && v != last_vertex());
+    for (auto a = first_arc(u.index()); !(a == nil_arc()); a = next_arc(a))
+      if (a.tip >= v.index())
+        return (a.tip == v.index()) ? EdgeDescriptor(this, a) : last_edge();
+    return last_edge();
+  }
+  EdgeDescriptor get_sibling(EdgeDescriptor e, VertexDescriptor u) {
+    assert(e != last_edge() && u != last_vertex());
+    return get_edge(e->tip, u);
+  }
+  int degree(VertexDescriptor u) {
+    uint32_t pos = boffs_[u.index()];
+    return get_varint(pos);
+  }
+
+  // packed specifics
+public:
+  // whole row at once, tips ascending
+  void decode_row(int u, vector<int> &tips) {
+    tips.clear();
+    for (auto a = first_arc(u); !(a == nil_arc()); a = next_arc(a))
+      tips.push_back(a.tip);
+  }
+
+  // bytes of adjacency: gap stream and both offset arrays
+  size_t adjacency_bytes() const {
+    return bytes_.size() + (boffs_.size() + aoffs_.size()) * sizeof(uint32_t);
+  }
+
+  friend ostream &operator<<(ostream &stream, PackedGraph &g) {
+    out_dot_to_stream(stream, g);
+    return stream;
+  }
+};
+
+template <typename VL, typename EL> EL PackedGraph<VL, EL>::empty_load_;
+}
+
+#endif
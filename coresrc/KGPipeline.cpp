@@ -0,0 +1,314 @@
+//===-- KGPipeline.cpp -- staged vertex cover driver supplement -----------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGPipeline.hpp"
+#include "KGCache.hpp"
+#include "KGFormats.hpp"
+
+#include <dirent.h>
+
+namespace KGR {
+
+using Clock = SolveBudget::clock;
+
+// one input file on its way through stages
+struct PipelineItem {
+  size_t idx = 0;
+  bool ok = false;
+  int n = 0;
+  VCProblem problem;
+  VCProblem kernel;       // half-integral part of problem
+  vector<int> kernel_ids; // kernel vertex to problem vertex
+  vector<int> lpclasses;  // of problem, kept for cache
+  VCSolution solution;    // forced vertices and LP bound, then all
+  CacheKey ckey, gkey;    // content and graph keys if cache is used
+  int hit = 0;            // 0 miss, 1 graph hit, 2 content hit
+};
+
+using ItemPtr = std::unique_ptr<PipelineItem>;
+using ItemQueue = BoundedQueue<ItemPtr>;
+
+static double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// stage threads loop over work(), stats are summed when all finished
+template <typename F>
+static void run_stage(StageStats &stats, const char *name, int nthreads,
+                      vector<std::thread> &threads, F work) {
+  stats.name = name;
+  stats.nthreads = nthreads;
+  auto mutex = std::make_shared<std::mutex>();
+  for (int t = 0; t != nthreads; ++t)
+    threads.emplace_back([&stats, mutex, work]() mutable {
+      StageStats local;
+      work(local);
+      std::lock_guard<std::mutex> lock(*mutex);
+      stats.items += local.items;
+      stats.busy += local.busy;
+      stats.wait += local.wait;
+    });
+}
+
+// pop and push with time accounted as wait
+static bool timed_pop(ItemQueue &q, ItemPtr &item, StageStats &local) {
+  auto start = Clock::now();
+  bool res = q.pop(item);
+  local.wait += seconds_since(start);
+  return res;
+}
+
+static void timed_push(ItemQueue &q, ItemPtr item, StageStats &local) {
+  auto start = Clock::now();
+  q.push(std::move(item));
+  local.wait += seconds_since(start);
+}
+
+// LP classes of problem: 2 goes to cover, 1 to kernel, 0 is dropped
+static void kernelize(VCWorkspace &ws, PipelineItem &it) {
+  const VCProblem &p = it.problem;
+  ws.load(p);
+  int matching = ws.lp_kernel();
+  auto &cls = ws.lp_classes();
+  vector<int> pos(p.n, -1);
+  it.kernel.cleanup();
+  it.kernel_ids.clear();
+  it.solution = VCSolution();
+  it.solution.lpbound = (matching + 1) / 2;
+  for (int v = 0; v != p.n; ++v)
+    if (cls[v] == 1) {
+      pos[v] = it.kernel_ids.size();
+      it.kernel_ids.push_back(v);
+    } else if (cls[v] == 2)
+      it.solution.cover.push_back(v);
+  it.kernel.add_isolated(it.kernel_ids.size());
+  for (auto e : p.edges)
+    if (pos[e.first] != -1 && pos[e.second] != -1)
+      it.kernel.add_link(pos[e.first], pos[e.second]);
+  it.solution.nkernel = it.kernel.n;
+  it.lpclasses = cls;
+}
+
+// content key is checked before parsing, graph key before kernel
+static void load_cached(SolutionCache &cache, const string &path,
+                        PipelineItem &it) {
+  MappedFile in;
+  it.ok = in.map(path.c_str(), false);
+  if (!it.ok)
+    return;
+  it.ckey = content_key(in.data(), in.size());
+  CacheEntry entry;
+  if (cache.find(it.ckey, entry))
+    it.hit = 2;
+  else {
+    istringstream iss(in.size() ? string(in.data(), in.size()) : string());
+    read_graph_from_stream(iss, it.problem);
+    it.n = it.problem.n;
+    it.gkey = graph_key(it.problem);
+    if (cache.find(it.gkey, entry))
+      it.hit = 1;
+  }
+  if (it.hit) {
+    it.n = entry.n;
+    it.solution = std::move(entry.solution);
+  }
+}
+
+// misses stored under graph key, both misses and graph hits get alias
+static void store_cached(SolutionCache &cache, PipelineItem &it) {
+  if (it.hit == 0 && it.solution.complete) {
+    CacheEntry entry;
+    entry.n = it.n;
+    entry.solution = it.solution;
+    entry.lpclasses = std::move(it.lpclasses);
+    cache.insert(it.gkey, entry);
+  }
+  if (it.hit != 2)
+    cache.alias(it.gkey, it.ckey);
+}
+
+// kernel cover mapped back and merged with forced vertices; kernel stage
+// already ran LP, so search starts right away
+static void solve_kernel(VCWorkspace &ws, PipelineItem &it,
+                         Clock::duration timeout) {
+  SolveBudget budget;
+  if (timeout != Clock::duration(0)) {
+    budget.set_timeout(timeout);
+    ws.set_budget(&budget);
+  }
+  VCSolution ksol = ws.solve_kernel(it.kernel);
+  ws.set_budget(nullptr);
+  auto &sol = it.solution;
+  for (auto v : ksol.cover)
+    sol.cover.push_back(it.kernel_ids[v]);
+  std::sort(sol.cover.begin(), sol.cover.end());
+  sol.size = sol.cover.size();
+  sol.complete = ksol.complete;
+}
+
+// input "dir/name.ext" becomes "out_dir/name.vc" or "dir/name.vc"
+static string output_path(const string &path, const string &out_dir) {
+  size_t slash = path.rfind('/');
+  size_t base = (slash == string::npos) ? 0 : slash + 1;
+  size_t dot = path.rfind('.');
+  if (dot == string::npos || dot < base)
+    dot = path.size();
+  if (out_dir.empty())
+    return path.substr(0, dot) + ".vc";
+  return out_dir + "/" + path.substr(base, dot - base) + ".vc";
+}
+
+// same format as out_pace_vc_to_stream; false if file can not be
+// opened or written, including final flush on close
+static bool write_vc(const string &name, const PipelineItem &it) {
+  ofstream ofs(name, ofstream::out | ofstream::trunc);
+  if (!ofs)
+    return false;
+  {
+    BufWriter w(ofs);
+    w.put("s vc ");
+    w.put_uint(it.n);
+    w.put(' ');
+    w.put_uint(it.solution.size);
+    w.put('\n');
+    for (auto v : it.solution.cover) {
+      w.put_uint(v + 1);
+      w.put('\n');
+    }
+  }
+  ofs.close();
+  return !ofs.fail();
+}
+
+PipelineReport vc_pipeline(const vector<string> &paths,
+                           const PipelineConfig &cfg,
+                           PipelineCallback callback) {
+  PipelineReport rep;
+  auto start = Clock::now();
+  int nload = thread_count(cfg.nload), nkernel = thread_count(cfg.nkernel);
+  int nsolve = thread_count(cfg.nsolve), nwrite = thread_count(cfg.nwrite);
+  ItemQueue loaded(cfg.queue_size, nload);
+  ItemQueue kernelized(cfg.queue_size, nkernel);
+  ItemQueue solved(cfg.queue_size, nsolve);
+  std::atomic<size_t> next{0}, nfailed{0}, nhits{0}, nunwritten{0};
+  vector<std::thread> threads;
+
+  run_stage(rep.stages[0], "load", nload, threads, [&](StageStats &local) {
+    for (size_t idx = next++; idx < paths.size(); idx = next++) {
+      auto t0 = Clock::now();
+      ItemPtr it(new PipelineItem);
+      it->idx = idx;
+      if (cfg.cache)
+        load_cached(*cfg.cache, paths[idx], *it);
+      else {
+        ifstream ifs(paths[idx]);
+        it->ok = ifs.is_open();
+        if (it->ok)
+          read_graph_from_stream(ifs, it->problem);
+        it->n = it->problem.n;
+      }
+      local.items += 1;
+      local.busy += seconds_since(t0);
+      timed_push(loaded, std::move(it), local);
+    }
+    loaded.done();
+  });
+
+  run_stage(rep.stages[1], "kernel", nkernel, threads,
+            [&](StageStats &local) {
+              VCWorkspace ws;
+              ItemPtr it;
+              while (timed_pop(loaded, it, local)) {
+                auto t0 = Clock::now();
+                if (it->ok && !it->hit)
+                  kernelize(ws, *it);
+                local.items += 1;
+                local.busy += seconds_since(t0);
+                timed_push(kernelized, std::move(it), local);
+              }
+              kernelized.done();
+            });
+
+  run_stage(rep.stages[2], "solve", nsolve, threads, [&](StageStats &local) {
+    VCWorkspace ws;
+    ws.set_memo(cfg.memo);
+    ItemPtr it;
+    while (timed_pop(kernelized, it, local)) {
+      auto t0 = Clock::now();
+      if (it->ok && !it->hit)
+        solve_kernel(ws, *it, cfg.timeout);
+      local.items += 1;
+      local.busy += seconds_since(t0);
+      timed_push(solved, std::move(it), local);
+    }
+    solved.done();
+  });
+
+  run_stage(rep.stages[3], "write", nwrite, threads, [&](StageStats &local) {
+    ItemPtr it;
+    while (timed_pop(solved, it, local)) {
+      auto t0 = Clock::now();
+      const string &path = paths[it->idx];
+      if (!it->ok)
+        nfailed += 1;
+      else {
+        nhits += (it->hit != 0);
+        if (cfg.cache)
+          store_cached(*cfg.cache, *it);
+        if (cfg.out_dir != "-" &&
+            !write_vc(output_path(path, cfg.out_dir), *it))
+          nunwritten += 1;
+      }
+      if (callback)
+        callback(it->idx, path, it->solution);
+      local.items += 1;
+      local.busy += seconds_since(t0);
+    }
+  });
+
+  for (auto &t : threads)
+    t.join();
+  rep.seconds = seconds_since(start);
+  rep.nfailed = nfailed;
+  rep.nhits = nhits;
+  rep.nunwritten = nunwritten;
+  return rep;
+}
+
+ostream &operator<<(ostream &stream, const PipelineReport &r) {
+  stream << "stage   threads   items   items/s   busy   wait\n";
+  for (auto &s : r.stages) {
+    double rate = (r.seconds > 0) ? s.items / r.seconds : 0;
+    double busy = (r.seconds > 0) ? s.busy / (s.nthreads * r.seconds) : 0;
+    double wait = (r.seconds > 0) ? s.wait / (s.nthreads * r.seconds) : 0;
+    stream << std::left << std::setw(8) << s.name << std::right
+           << std::setw(7) << s.nthreads << std::setw(8) << s.items
+           << std::fixed << std::setprecision(1) << std::setw(10) << rate
+           << std::setprecision(2) << std::setw(7) << busy << std::setw(7)
+           << wait << std::defaultfloat << "\n";
+  }
+  stream << "total " << r.seconds << " s, " << r.nfailed << " failed, "
+         << r.nhits << " cached, " << r.nunwritten << " not written\n";
+  return stream;
+}
+
+vector<string> list_files(const string &dir, const string &ext) {
+  vector<string> res;
+  DIR *d = opendir(dir.c_str());
+  if (!d)
+    return res;
+  while (struct dirent *ent = readdir(d)) {
+    string name = ent->d_name;
+    if (name.size() > ext.size() &&
+        name.compare(name.size() - ext.size(), ext.size(), ext) == 0)
+      res.push_back(dir + "/" + name);
+  }
+  closedir(d);
+  std::sort(res.begin(), res.end());
+  return res;
+}
+}
@@ -0,0 +1,128 @@
+//===-- KGPipeline.hpp -- staged load, kernelize, solve, write driver -----===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// BoundedQueue -- blocking queue with capacity, closed by its producers
+//
+// vc_pipeline -- vertex covers for many input files, four stages with own
+//                threads, bounded queues between them:
+//   load   -- read_graph_from_stream to VCProblem
+//   kernel -- LP kernel, problem reduced to half-integral vertices
+//   solve  -- bounded search on kernel, optional timeout per problem,
+//             optional CoverMemo for small kernel components
+//   write  -- cover of whole problem to PACE .vc file and callback
+// With SolutionCache (KGCache.hpp) load stage looks up raw file bytes
+// first, then parsed graph; hits pass kernel and solve stages untouched,
+// misses are stored by write stage.
+//
+// Full queue blocks its producer, so memory is bounded by queue sizes and
+// stage thread counts, not by number of files. Parsing of next files
+// overlaps with solving of previous ones, and writes overlap with both.
+//
+// Every stage counts items, time in work and time blocked on queues;
+// report shows which stage is bottleneck (utilization near 1).
+//
+// list_files -- sorted paths of directory entries with given extension
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KPIPELINE_GUARD__
+#define GRAPH_KPIPELINE_GUARD__
+
+#include "KGSolver.hpp"
+
+namespace KGR {
+
+class SolutionCache;
+
+template <typename T> class BoundedQueue final {
+  std::deque<T> items_;
+  size_t capacity_;
+  int producers_;
+  std::mutex mutex_;
+  std::condition_variable not_full_, not_empty_;
+
+public:
+  BoundedQueue(size_t capacity, int producers)
+      : capacity_(capacity), producers_(producers) {
+    assert(capacity > 0 && producers > 0);
+  }
+
+  // blocks while full
+  void push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+    items_.push_back(std::move(item));
+    lock.unlock();
+    not_empty_.notify_one();
+  }
+
+  // blocks while empty, false when empty and all producers are done
+  bool pop(T &item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock,
+                    [this] { return !items_.empty() || producers_ == 0; });
+    if (items_.empty())
+      return false;
+    item = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+    not_full_.notify_one();
+    return true;
+  }
+
+  // every producer calls it once, last one wakes all consumers
+  void done() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    assert(producers_ > 0);
+    if (--producers_ == 0)
+      not_empty_.notify_all();
+  }
+};
+
+struct PipelineConfig {
+  int nload = 1, nkernel = 1, nsolve = 0, nwrite = 1; // 0: all cores
+  size_t queue_size = 8;                              // between stages
+  string out_dir; // empty: .vc next to input, "-": no files written
+  SolveBudget::clock::duration timeout{0}; // per problem, 0: none
+  SolutionCache *cache = nullptr;          // shall be open, or nullptr
+  CoverMemo *memo = nullptr; // shared by solve threads, or nullptr
+};
+
+struct StageStats {
+  const char *name = "";
+  int nthreads = 0;
+  size_t items = 0;
+  double busy = 0; // thread-seconds in work
+  double wait = 0; // thread-seconds blocked on queues
+};
+
+struct PipelineReport {
+  StageStats stages[4];  // load, kernel, solve, write
+  double seconds = 0;    // wall time of whole run
+  size_t nfailed = 0;    // inputs that could not be opened
+  size_t nhits = 0;      // inputs found in cache
+  size_t nunwritten = 0; // .vc files that could not be written
+
+  // items per second and utilization of every stage
+  friend ostream &operator<<(ostream &stream, const PipelineReport &r);
+};
+
+// callback(idx, path, solution) runs on write threads, possibly
+// concurrently; solution of unreadable input is empty
+using PipelineCallback =
+    std::function<void(size_t, const string &, const VCSolution &)>;
+
+PipelineReport vc_pipeline(const vector<string> &paths,
+                           const PipelineConfig &cfg,
+                           PipelineCallback callback = nullptr);
+
+vector<string> list_files(const string &dir, const string &ext);
+}
+
+#endif
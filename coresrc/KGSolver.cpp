@@ -0,0 +1,623 @@
+//===-- KGSolver.cpp -- index-based vertex cover solver supplement --------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGSolver.hpp"
+#include "KGCanon.hpp"
+#include "KGStatic.hpp"
+
+namespace KGR {
+
+// residuals this small are finished by lookup instead of branching
+static constexpr int small_k = 5;
+static constexpr SmallCovers<small_k> small_covers{};
+
+void VCWorkspace::load(const VCProblem &p) {
+  n_ = p.n;
+  offsets_.assign(n_ + 1, 0);
+  for (auto e : p.edges) {
+    offsets_[e.first + 1] += 1;
+    offsets_[e.second + 1] += 1;
+  }
+  for (int v = 0; v != n_; ++v)
+    offsets_[v + 1] += offsets_[v];
+
+  // iter_ used as fill position here
+  iter_.assign(offsets_.begin(), offsets_.end() - 1);
+  targets_.resize(offsets_[n_]);
+  for (auto e : p.edges) {
+    targets_[iter_[e.first]++] = e.second;
+    targets_[iter_[e.second]++] = e.first;
+  }
+
+  // parallel edges removed: clique bound counts neighbors
+  int pos = 0;
+  for (int v = 0; v != n_; ++v) {
+    auto first = targets_.begin() + offsets_[v];
+    auto last = targets_.begin() + offsets_[v + 1];
+    std::sort(first, last);
+    last = std::unique(first, last);
+    offsets_[v] = pos;
+    pos = std::copy(first, last, targets_.begin() + pos) - targets_.begin();
+  }
+  offsets_[n_] = pos;
+  targets_.resize(pos);
+  off_ = offsets_.data();
+  tgt_ = targets_.data();
+}
+
+void VCWorkspace::load_csr(int n, const int *offsets, const int *targets) {
+  n_ = n;
+  off_ = offsets;
+  tgt_ = targets;
+}
+
+bool VCWorkspace::load_csr(int n, const uint64_t *offsets,
+                           const int *targets) {
+  if (offsets[n] > (uint64_t)std::numeric_limits<int>::max())
+    return false;
+  offsets_.assign(offsets, offsets + n + 1);
+  n_ = n;
+  off_ = offsets_.data();
+  tgt_ = targets;
+  return true;
+}
+
+bool VCWorkspace::hk_bfs() {
+  const int inf = std::numeric_limits<int>::max();
+  bool found = false;
+  queue_.clear();
+  for (auto u : active_)
+    if (mate_l_[u] == -1) {
+      dist_[u] = 0;
+      queue_.push_back(u);
+    } else
+      dist_[u] = inf;
+
+  for (size_t qpos = 0; qpos != queue_.size(); ++qpos) {
+    if (stopped())
+      return false;
+    int u = queue_[qpos];
+    for (int a = off_[u]; a != off_[u + 1]; ++a) {
+      if (state_[tgt_[a]] != 0)
+        continue;
+      int w = mate_r_[tgt_[a]];
+      if (w == -1)
+        found = true;
+      else if (dist_[w] == inf) {
+        dist_[w] = dist_[u] + 1;
+        queue_.push_back(w);
+      }
+    }
+  }
+  return found;
+}
+
+// augmenting path from free root, iterative: path_ holds left vertices
+// of current path, iter_ of each one points to its arc being tried, so
+// path_ with iter_ is stack of (vertex, arc) pairs; long paths do not
+// grow call stack
+bool VCWorkspace::hk_dfs(int root) {
+  const int inf = std::numeric_limits<int>::max();
+  path_.assign(1, root);
+  while (!path_.empty()) {
+    int u = path_.back();
+    int next = -1;
+    for (int &a = iter_[u]; a != off_[u + 1]; ++a) {
+      int v = tgt_[a];
+      if (state_[v] != 0)
+        continue;
+      int w = mate_r_[v];
+      if (w == -1) {
+        // free right vertex: flip whole path along current arcs
+        for (auto x : path_) {
+          int y = tgt_[iter_[x]];
+          mate_l_[x] = y;
+          mate_r_[y] = x;
+        }
+        return true;
+      }
+      if (dist_[w] == dist_[u] + 1) {
+        next = w;
+        break;
+      }
+    }
+    if (next != -1) {
+      path_.push_back(next);
+      continue;
+    }
+
+    // dead end: u is not tried again in this phase, parent moves on
+    dist_[u] = inf;
+    path_.pop_back();
+    if (!path_.empty())
+      iter_[path_.back()] += 1;
+  }
+  return false;
+}
+
+// Hopcroft-Karp phases on active_, starting from current mates; budget
+// is polled per root, so stopped matching is valid but not maximum
+int VCWorkspace::hk_augment(int matching) {
+  while (!stopped() && hk_bfs()) {
+    for (auto u : active_)
+      iter_[u] = off_[u];
+    for (auto u : active_) {
+      if (stopped())
+        break;
+      if (mate_l_[u] == -1 && hk_dfs(u))
+        matching += 1;
+    }
+  }
+  return matching;
+}
+
+// empty matching and undecided vertices, arrays sized for loaded problem
+void VCWorkspace::reset_lp() {
+  halted_ = false;
+  mate_l_.assign(n_, -1);
+  mate_r_.assign(n_, -1);
+  dist_.resize(n_);
+  iter_.resize(n_);
+  state_.assign(n_, 0);
+  active_.resize(n_);
+  for (int u = 0; u != n_; ++u)
+    active_[u] = u;
+}
+
+int VCWorkspace::lp_kernel() {
+  int matching = 0;
+  reset_lp();
+
+  // greedy start, Hopcroft-Karp phases only finish the job
+  for (int u = 0; u != n_; ++u)
+    for (int a = off_[u]; a != off_[u + 1]; ++a)
+      if (mate_r_[tgt_[a]] == -1) {
+        mate_l_[u] = tgt_[a];
+        mate_r_[tgt_[a]] = u;
+        matching += 1;
+        break;
+      }
+
+  matching = hk_augment(matching);
+
+  // stopped: Koenig needs maximum matching, so nothing is decided and
+  // whole graph is kernel; matching still bounds LP from below
+  if (halted_) {
+    lpclass_.assign(n_, 1);
+    return matching;
+  }
+
+  // Koenig: Z is reachable from free left vertices by alternating paths
+  // cover is (L \ Z) + (R & Z), class is [left in cover] + [right in cover]
+  // dist_ marks left part of Z, lpclass_ collects right part
+  const int inf = std::numeric_limits<int>::max();
+  lpclass_.assign(n_, 1);
+  queue_.clear();
+  for (int u = 0; u != n_; ++u)
+    if (mate_l_[u] == -1) {
+      dist_[u] = 0;
+      lpclass_[u] -= 1;
+      queue_.push_back(u);
+    } else
+      dist_[u] = inf;
+
+  for (size_t qpos = 0; qpos != queue_.size(); ++qpos) {
+    int u = queue_[qpos];
+    for (int a = off_[u]; a != off_[u + 1]; ++a) {
+      int v = tgt_[a];
+      int w = mate_r_[v];
+      // w == -1 impossible: it would be augmenting path
+      if (dist_[w] == inf) {
+        dist_[w] = 0;
+        lpclass_[w] -= 1;
+        queue_.push_back(w);
+      }
+    }
+  }
+
+  // right part of Z is exactly mates of left part of Z except free ones
+  for (int u = 0; u != n_; ++u)
+    if (dist_[u] == 0 && mate_l_[u] != -1)
+      lpclass_[mate_l_[u]] += 1;
+
+  return matching;
+}
+
+void VCWorkspace::set_mate(int v, int m) {
+  mtrail_.emplace_back(v, gmate_[v]);
+  gmate_[v] = m;
+}
+
+void VCWorkspace::take(int v) {
+  state_[v] = 1;
+  trail_.push_back(v);
+  for (int a = off_[v]; a != off_[v + 1]; ++a)
+    if (state_[tgt_[a]] == 0)
+      deg_[tgt_[a]] -= 1;
+
+  // matching stays maximal: mate of v is free now, try to rematch it
+  int u = gmate_[v];
+  if (u == -1)
+    return;
+  set_mate(v, -1);
+  set_mate(u, -1);
+  msize_ -= 1;
+  for (int a = off_[u]; a != off_[u + 1]; ++a) {
+    int w = tgt_[a];
+    if (state_[w] == 0 && gmate_[w] == -1) {
+      set_mate(u, w);
+      set_mate(w, u);
+      msize_ += 1;
+      break;
+    }
+  }
+}
+
+// msize_ is restored by caller
+void VCWorkspace::undo(size_t mark, size_t mmark) {
+  while (trail_.size() != mark) {
+    int v = trail_.back();
+    trail_.pop_back();
+    for (int a = off_[v]; a != off_[v + 1]; ++a)
+      if (state_[tgt_[a]] == 0)
+        deg_[tgt_[a]] += 1;
+    state_[v] = 0;
+  }
+  while (mtrail_.size() != mmark) {
+    gmate_[mtrail_.back().first] = mtrail_.back().second;
+    mtrail_.pop_back();
+  }
+}
+
+// greedy clique partition of residual: cover misses at most one vertex
+// of every clique; vertex joins clique of its first neighbor if it sees
+// all members
+int VCWorkspace::clique_bound() {
+  int bound = 0, nclique = 0;
+  for (auto v : kernel_)
+    clique_[v] = -1;
+  for (auto v : kernel_) {
+    if (state_[v] != 0 || deg_[v] == 0 || clique_[v] != -1)
+      continue;
+    int id = nclique++, size = 1;
+    clique_[v] = id;
+    for (int a = off_[v]; a != off_[v + 1]; ++a) {
+      int w = tgt_[a];
+      if (state_[w] != 0 || clique_[w] != -1)
+        continue;
+      int common = 0;
+      for (int b = off_[w]; b != off_[w + 1]; ++b)
+        if (clique_[tgt_[b]] == id)
+          common += 1;
+      if (common == size) {
+        clique_[w] = id;
+        size += 1;
+      }
+    }
+    bound += size - 1;
+  }
+  return bound;
+}
+
+// LP value of residual, rounded up: matching in its bipartite double,
+// warm started from maximal matching taken in both directions
+int VCWorkspace::residual_lp() {
+  int matching = 0;
+  active_.clear();
+  for (auto v : kernel_)
+    if (state_[v] == 0 && deg_[v] > 0) {
+      active_.push_back(v);
+      mate_l_[v] = mate_r_[v] = -1;
+    }
+  for (auto v : active_)
+    if (gmate_[v] != -1) {
+      mate_l_[v] = gmate_[v];
+      mate_r_[gmate_[v]] = v;
+      matching += 1;
+    }
+  return (hk_augment(matching) + 1) / 2;
+}
+
+// stops as soon as bound reaches need, expensive bounds go last
+int VCWorkspace::lower_bound(int nedges, int dmax, int need) {
+  int lb = std::max((nedges + dmax - 1) / dmax, msize_);
+  if (lb >= need)
+    return lb;
+  lb = std::max(lb, clique_bound());
+  if (lb >= need)
+    return lb;
+  return std::max(lb, residual_lp());
+}
+
+// classic bounded search tree: leaf rule, then branch on max degree vertex
+// taking it or taking all its neighbors; at most small_k non-isolated
+// vertices are finished by table
+void VCWorkspace::search(int cursize) {
+  if (cursize >= bestsz_ || bestsz_ <= target_)
+    return;
+  if (stopped())
+    return;
+
+  int vmax = -1, dmax = 0, leaf = -1, degsum = 0, nactive = 0;
+  int few[small_k];
+  for (auto v : kernel_)
+    if (state_[v] == 0) {
+      int d = deg_[v];
+      degsum += d;
+      if (d != 0 && nactive++ < small_k)
+        few[nactive - 1] = v;
+      if (d == 1)
+        leaf = v;
+      if (d > dmax) {
+        dmax = d;
+        vmax = v;
+      }
+    }
+
+  if (dmax == 0) {
+    bestsz_ = cursize;
+    for (size_t i = 0; i != kernel_.size(); ++i)
+      best_[i] = (state_[kernel_[i]] == 1);
+    if (budget_)
+      budget_->set_upper(forced_ + cursize);
+    return;
+  }
+
+  size_t mark = trail_.size(), mmark = mtrail_.size();
+  int msave = msize_;
+  if (nactive <= small_k) {
+    uint32_t emask = 0;
+    for (int j = 1; j != nactive; ++j)
+      for (int a = off_[few[j]]; a != off_[few[j] + 1]; ++a)
+        for (int i = 0; i != j; ++i)
+          if (tgt_[a] == few[i])
+            emask |= uint32_t(1) << small_covers.pair_bit(i, j);
+    uint32_t cover = small_covers.cover[emask];
+    for (int i = 0; i != nactive; ++i)
+      if ((cover >> i) & 1)
+        take(few[i]);
+    search(cursize + __builtin_popcount(cover));
+    undo(mark, mmark);
+    msize_ = msave;
+    return;
+  }
+
+  // rest of cover must be smaller than need to improve
+  int need = bestsz_ - cursize;
+  if (lower_bound(degsum / 2, dmax, need) >= need)
+    return;
+
+  if (leaf != -1) {
+    for (int a = off_[leaf]; a != off_[leaf + 1]; ++a)
+      if (state_[tgt_[a]] == 0) {
+        take(tgt_[a]);
+        break;
+      }
+    search(cursize + 1);
+    undo(mark, mmark);
+    msize_ = msave;
+    return;
+  }
+
+  take(vmax);
+  search(cursize + 1);
+  undo(mark, mmark);
+  msize_ = msave;
+
+  int ntaken = 0;
+  for (int a = off_[vmax]; a != off_[vmax + 1]; ++a)
+    if (state_[tgt_[a]] == 0) {
+      take(tgt_[a]);
+      ntaken += 1;
+    }
+  search(cursize + ntaken);
+  undo(mark, mmark);
+  msize_ = msave;
+}
+
+// LP kernel and search state, returns number of vertices with x = 1
+// p already reduced by LP kernel has all-half LP optimum, so LP is not
+// run again and its value is half of vertices
+int VCWorkspace::prepare(const VCProblem &p, VCSolution &res, bool reduced) {
+  load(p);
+  if (reduced) {
+    reset_lp();
+    lpclass_.assign(n_, 1);
+    res.lpbound = (n_ + 1) / 2;
+  } else
+    res.lpbound = (lp_kernel() + 1) / 2;
+
+  // kernel vertices undecided, others already fixed for search
+  int forced = 0;
+  kernel_.clear();
+  deg_.resize(n_);
+  for (int v = 0; v != n_; ++v) {
+    state_[v] = (lpclass_[v] == 1) ? 0 : (lpclass_[v] == 2) ? 1 : 2;
+    if (lpclass_[v] == 1)
+      kernel_.push_back(v);
+    if (lpclass_[v] == 2)
+      forced += 1;
+  }
+  for (auto v : kernel_) {
+    deg_[v] = 0;
+    for (int a = off_[v]; a != off_[v + 1]; ++a)
+      if (state_[tgt_[a]] == 0)
+        deg_[v] += 1;
+  }
+
+  // greedy maximal matching inside kernel
+  gmate_.assign(n_, -1);
+  mtrail_.clear();
+  msize_ = 0;
+  for (auto v : kernel_)
+    for (int a = off_[v]; a != off_[v + 1] && gmate_[v] == -1; ++a)
+      if (state_[tgt_[a]] == 0 && gmate_[tgt_[a]] == -1) {
+        gmate_[v] = tgt_[a];
+        gmate_[tgt_[a]] = v;
+        msize_ += 1;
+      }
+  clique_.assign(n_, -1);
+
+  // all kernel is always a cover
+  res.nkernel = kernel_.size();
+  bestsz_ = kernel_.size();
+  best_.assign(kernel_.size(), 1);
+  target_ = -1;
+  trail_.clear();
+  forced_ = forced;
+  if (budget_) {
+    budget_->set_lower(res.lpbound);
+    budget_->set_upper(forced + bestsz_);
+  }
+  return forced;
+}
+
+void VCWorkspace::finish(VCSolution &res) {
+  for (size_t i = 0; i != kernel_.size(); ++i)
+    if (best_[i])
+      lpclass_[kernel_[i]] = 2;
+  for (int v = 0; v != n_; ++v)
+    if (lpclass_[v] == 2)
+      res.cover.push_back(v);
+  res.size = res.cover.size();
+  res.complete = !halted_;
+
+  // restore kernel classes for lp_classes() users
+  for (auto v : kernel_)
+    lpclass_[v] = 1;
+}
+
+// kernel components small enough for memo get their minimum covers
+// taken, rest stays for search; returns number of vertices taken
+int VCWorkspace::memo_components() {
+  if (!memo_)
+    return 0;
+  int ntaken = 0;
+  comp_.assign(n_, -1);
+  for (auto s : kernel_) {
+    if (state_[s] != 0 || comp_[s] != -1)
+      continue;
+    members_.clear();
+    members_.push_back(s);
+    comp_[s] = 0;
+    for (size_t i = 0; i != members_.size(); ++i) {
+      int v = members_[i];
+      for (int a = off_[v]; a != off_[v + 1]; ++a)
+        if (state_[tgt_[a]] == 0 && comp_[tgt_[a]] == -1) {
+          comp_[tgt_[a]] = members_.size();
+          members_.push_back(tgt_[a]);
+        }
+    }
+    if (members_.size() < 2 || members_.size() > size_t(canon_max))
+      continue;
+
+    SmallGraph g;
+    g.n = members_.size();
+    for (int i = 0; i != g.n; ++i) {
+      int v = members_[i];
+      for (int a = off_[v]; a != off_[v + 1]; ++a)
+        if (state_[tgt_[a]] == 0)
+          g.adj[i] |= uint32_t(1) << comp_[tgt_[a]];
+    }
+    uint32_t cover = memo_->cover(g);
+    for (int i = 0; i != g.n; ++i)
+      if ((cover >> i) & 1)
+        take(members_[i]);
+    ntaken += __builtin_popcount(cover);
+  }
+  return ntaken;
+}
+
+VCSolution VCWorkspace::solve(const VCProblem &p) {
+  VCSolution res;
+  prepare(p, res);
+  search(memo_components());
+  finish(res);
+  return res;
+}
+
+VCSolution VCWorkspace::solve_kernel(const VCProblem &kernel) {
+  VCSolution res;
+  prepare(kernel, res, true);
+  search(memo_components());
+  finish(res);
+  return res;
+}
+
+// matched kernel vertices cover kernel (matching is maximal), then ones
+// with all neighbors in cover are dropped
+void VCWorkspace::approx_cover() {
+  for (auto v : kernel_)
+    state_[v] = (gmate_[v] != -1) ? 1 : 0;
+  for (auto v : kernel_) {
+    if (state_[v] != 1)
+      continue;
+    bool redundant = true;
+    for (int a = off_[v]; a != off_[v + 1] && redundant; ++a)
+      redundant = (state_[tgt_[a]] != 0);
+    if (redundant)
+      state_[v] = 0;
+  }
+  bestsz_ = 0;
+  for (size_t i = 0; i != kernel_.size(); ++i) {
+    best_[i] = (state_[kernel_[i]] == 1);
+    bestsz_ += best_[i];
+    state_[kernel_[i]] = 0;
+  }
+}
+
+VCSolution VCWorkspace::minimize(const VCProblem &p, VCProof &proof) {
+  VCSolution res;
+  int forced = prepare(p, res);
+  approx_cover();
+  proof.upper = forced + bestsz_;
+  if (budget_)
+    budget_->set_upper(proof.upper);
+
+  int degsum = 0, dmax = 0;
+  for (auto v : kernel_) {
+    degsum += deg_[v];
+    dmax = std::max(dmax, deg_[v]);
+  }
+  int lower = 0;
+  if (dmax != 0)
+    lower = lower_bound(degsum / 2, dmax, std::numeric_limits<int>::max());
+  proof.lower = std::max(res.lpbound, forced + lower);
+  if (budget_)
+    budget_->set_lower(proof.lower);
+
+  // first cover of root bound size is optimal, search may stop there
+  if (proof.upper > proof.lower) {
+    target_ = proof.lower - forced;
+    search(memo_components());
+    target_ = -1;
+  }
+  finish(res);
+  proof.by_bound = (res.size == proof.lower);
+  return res;
+}
+
+bool VCWorkspace::cover_within(const VCProblem &p, int k, VCSolution &res) {
+  res = VCSolution();
+  int budget = k - prepare(p, res);
+  if (res.lpbound > k)
+    return false;
+
+  // search only if whole kernel does not fit, first fit is enough
+  if ((int)kernel_.size() > budget) {
+    bestsz_ = budget + 1;
+    target_ = budget;
+    search(memo_components());
+    target_ = -1;
+    res.complete = !halted_;
+    if (bestsz_ > budget)
+      return false;
+  }
+  finish(res);
+  return true;
+}
+}
@@ -0,0 +1,192 @@
+//===-- KGSolver.hpp -- index-based vertex cover solver -------------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// VCProblem -- plain edge list, can be filled by any reader from KGFormats.hpp
+//
+// VCSolution -- minimum vertex cover with LP bound and kernel size
+//
+// VCWorkspace -- reusable solver state: CSR adjacency, Hopcroft-Karp on
+//                bipartite double, LP (Nemhauser-Trotter) kernel and
+//                bounded search tree for what is left in kernel
+//
+// Search prunes node when partial cover plus lower bound for the rest
+// reaches best known (or budget + 1 for decision). Bounds, cheap first:
+//   degree   -- ceil(m / dmax)
+//   matching -- maximal matching, kept incrementally through take/undo
+//   cliques  -- greedy clique partition, all but one of each clique
+//   LP       -- Hopcroft-Karp on double of residual graph, warm started
+//               from matching above; exact on bipartite residuals
+// Residual with at most 5 non-isolated vertices is not branched: its cover
+// comes from table computed at compile time (SmallCovers in KGStatic.hpp).
+// With CoverMemo (KGCanon.hpp) kernel components of at most 32 vertices
+// are covered from memo before search, search branches on larger ones.
+//
+// Same pipeline as duplicate_to_bipart, hopcroft_karp, matching_to_cover,
+// join_from_bipart on GraphBuilder, but on flat arrays: bipartite double is
+// implicit (left u adjacent to right v iff uv is edge). All arrays live in
+// workspace and keep their capacity, so one workspace per thread solves a
+// stream of small graphs without allocations.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KSOLVER_GUARD__
+#define GRAPH_KSOLVER_GUARD__
+
+#include "KGBudget.hpp"
+#include "KGInc.hpp"
+
+namespace KGR {
+
+class CoverMemo;
+
+// vertices are 0 .. n-1
+struct VCProblem {
+  int n = 0;
+  vector<pair<int, int>> edges;
+
+  // builder interface, enough for readers in KGFormats.hpp
+  void cleanup() {
+    n = 0;
+    edges.clear();
+  }
+  void add_isolated(int k) { n += k; }
+  void add_link(int i, int j) {
+    assert(i >= 0 && i < n);
+    assert(j >= 0 && j < n);
+    edges.emplace_back(i, j);
+  }
+};
+
+struct VCSolution {
+  int size = 0;      // minimum cover size
+  int lpbound = 0;   // LP relaxation value, rounded up
+  int nkernel = 0;   // vertices with x = 1/2 after LP kernel
+  vector<int> cover; // cover vertices, ascending
+  bool complete = true; // false if budget stopped search: best known cover
+};
+
+// why cover of minimize is minimum; if search was stopped by budget
+// (solution not complete), only lower and upper hold
+struct VCProof {
+  int lower = 0;         // bound at root: LP, then cliques on kernel
+  int upper = 0;         // 2-approximation on kernel, pruned
+  bool by_bound = false; // size meets lower, else search refuted size - 1
+};
+
+class VCWorkspace final {
+  int n_ = 0;
+
+  // CSR adjacency, every edge in both directions
+  // off_ and tgt_ point to own arrays or to borrowed ones
+  vector<int> offsets_, targets_;
+  const int *off_ = nullptr, *tgt_ = nullptr;
+
+  // Hopcroft-Karp arrays for bipartite double, over active_ vertices
+  vector<int> mate_l_, mate_r_, dist_, queue_, iter_, active_;
+  vector<int> path_; // left vertices of augmenting path being built
+
+  // 2x LP value for every vertex: 0, 1 (half) or 2
+  vector<int> lpclass_;
+
+  // bounded search tree on kernel
+  vector<int> kernel_, deg_, trail_;
+  vector<char> state_, best_;
+  int bestsz_ = 0;
+  int target_ = -1; // stop when cover this small found
+
+  // maximal matching of residual, trail has (vertex, old mate)
+  vector<int> gmate_;
+  vector<pair<int, int>> mtrail_;
+  int msize_ = 0;
+
+  // clique id per vertex for clique bound
+  vector<int> clique_;
+
+  // polled once per search node and once per Hopcroft-Karp root; stays
+  // halted until next lp_kernel
+  SolveBudget *budget_ = nullptr;
+  bool halted_ = false;
+  int forced_ = 0;
+
+  // small kernel components: vertex to position in component, -1 if
+  // not visited, and members of current one
+  CoverMemo *memo_ = nullptr;
+  vector<int> comp_, members_;
+
+  bool stopped() {
+    if (!halted_ && budget_ && budget_->expired())
+      halted_ = true;
+    return halted_;
+  }
+  bool hk_bfs();
+  bool hk_dfs(int root);
+  int hk_augment(int matching);
+  void set_mate(int v, int m);
+  void take(int v);
+  void undo(size_t mark, size_t mmark);
+  int clique_bound();
+  int residual_lp();
+  int lower_bound(int nedges, int dmax, int need);
+  void search(int cursize);
+  void reset_lp();
+  int prepare(const VCProblem &p, VCSolution &res, bool reduced = false);
+  void approx_cover();
+  int memo_components();
+  void finish(VCSolution &res);
+
+public:
+  // nullptr (default) means no limit, budget shall outlive solving
+  void set_budget(SolveBudget *budget) { budget_ = budget; }
+
+  // nullptr (default) means no memo, memo may be shared by workspaces
+  void set_memo(CoverMemo *memo) { memo_ = memo; }
+
+  // builds adjacency, previous problem is forgotten
+  void load(const VCProblem &p);
+
+  // borrows adjacency instead, like arrays of MappedGraph: rows without
+  // loops and repeats, arrays shall outlive next load
+  void load_csr(int n, const int *offsets, const int *targets);
+
+  // 64-bit offsets of MappedGraph are narrowed into own copy, targets are
+  // borrowed; arc indices here are int, so false (nothing loaded) if
+  // there are 2^31 arcs or more
+  bool load_csr(int n, const uint64_t *offsets, const int *targets);
+
+  // maximum matching in bipartite double (equals 2x LP value)
+  // fills LP classes; if budget stops it, matching is smaller and every
+  // class is 1, so solving ends with whole graph as cover, not complete
+  int lp_kernel();
+
+  // 0 (not in cover), 1 (kernel) or 2 (in cover) per vertex
+  const vector<int> &lp_classes() const { return lpclass_; }
+
+  // right mate of every left vertex after lp_kernel, -1 for free
+  const vector<int> &double_mates() const { return mate_l_; }
+
+  // exact minimum cover: LP kernel, then search on kernel
+  VCSolution solve(const VCProblem &p);
+
+  // same for problem that is already LP kernel (class 1 vertices of
+  // lp_kernel and edges between them): LP is not run again, every vertex
+  // goes to search, lpbound is half of vertices
+  VCSolution solve_kernel(const VCProblem &kernel);
+
+  // decision: some cover of size at most k, written to res if exists
+  // infeasible k is usually refuted by bounds near root
+  // false with res.complete unset if budget stopped search
+  bool cover_within(const VCProblem &p, int k, VCSolution &res);
+
+  // optimization mode: one kernel for all k, search starts below
+  // 2-approximation and stops at root lower bound
+  VCSolution minimize(const VCProblem &p, VCProof &proof);
+};
+}
+
+#endif
@@ -0,0 +1,108 @@
+//===-- KGSplit.hpp -- immutable graph with loads apart from topology -----===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// SplitLoads -- layout for Graph, structure of arrays: row offsets and arc
+//               tips in own arrays, vertex loads and edge loads in parallel
+//               arrays indexed by vertex and arc number
+//
+// SplitGraph -- Graph with SplitLoads, same constructors and handles
+//
+// InlineLoads keeps load next to offset of vertex and next to tip of arc,
+// so every scan of rows pulls loads into cache, and with large loads most
+// of every cache line is load. Here scan over vd->arcs and ed->tip reads
+// only offsets and tips; vd->load and ed->load are references into load
+// arrays, touched only when algorithm reads them.
+//
+// Topology arrays are exposed as is (g.layout().offsets(), tips()), so hot
+// loops may bypass handles and never see loads at all; g.arc(ed) is index
+// of edge load. Edge loads are kept only if EL is not empty type.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KSPLIT_GUARD__
+#define GRAPH_KSPLIT_GUARD__
+
+#include "KGraph.hpp"
+
+#include <type_traits>
+
+namespace KGR {
+
+template <typename VL, typename EL> class SplitLoads final {
+  vector<uint32_t> offsets_; // n + 1, arcs of v are offsets_[v] .. [v + 1]
+  vector<uint32_t> tips_;
+  vector<VL> vloads_;
+  vector<EL> eloads_; // empty for empty EL
+  static EL empty_load_;
+
+  static constexpr bool has_eloads = !std::is_empty<EL>::value;
+
+public:
+  SplitLoads() : offsets_(1, 0) {}
+
+  uint32_t &first(uint32_t v) { return offsets_[v]; }
+  uint32_t &tip(uint32_t a) { return tips_[a]; }
+  VL &vload(uint32_t v) { return vloads_[v]; }
+  EL &eload(uint32_t a) { return has_eloads ? eloads_[a] : empty_load_; }
+
+  void clear(size_t n) {
+    offsets_.clear();
+    tips_.clear();
+    vloads_.clear();
+    eloads_.clear();
+    offsets_.reserve(n + 1);
+    vloads_.reserve(n);
+  }
+  void push_vertex(const VL &load) {
+    offsets_.push_back(tips_.size());
+    vloads_.push_back(load);
+  }
+  void push_arc(uint32_t tip, const EL &load) {
+    tips_.push_back(tip);
+    if (has_eloads)
+      eloads_.push_back(load);
+  }
+  void close() { offsets_.push_back(tips_.size()); }
+
+  void resize(size_t n, size_t narcs) {
+    offsets_.assign(n + 1, 0);
+    tips_.assign(narcs, 0);
+    vloads_.assign(n, VL{});
+    eloads_.assign(has_eloads ? narcs : 0, EL{});
+  }
+
+  // arrays of bulk_csr are taken as they are
+  void assign_csr(vector<uint32_t> &offsets, vector<uint32_t> &targets,
+                  int) {
+    offsets_.swap(offsets);
+    tips_.swap(targets);
+    vloads_.assign(offsets_.size() - 1, VL{});
+    eloads_.assign(has_eloads ? tips_.size() : 0, EL{});
+  }
+
+  int nvertices() const { return offsets_.size() - 1; }
+  int narcs() const { return tips_.size(); }
+
+  // topology alone, n + 1 offsets and narcs tips
+  const uint32_t *offsets() const { return offsets_.data(); }
+  const uint32_t *tips() const { return tips_.data(); }
+
+  size_t topology_bytes() const {
+    return (offsets_.size() + tips_.size()) * sizeof(uint32_t);
+  }
+  size_t load_bytes() const {
+    return vloads_.size() * sizeof(VL) + eloads_.size() * sizeof(EL);
+  }
+};
+
+template <typename VL, typename EL> EL SplitLoads<VL, EL>::empty_load_;
+
+template <typename VL, typename EL>
+using SplitGraph = Graph<VL, EL, SplitLoads<VL, EL>>;
+}
+
+#endif
@@ -0,0 +1,205 @@
+//===-- KGStatic.hpp -- compile-time fixed-size graphs --------------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// StaticGraph -- N vertices and M edges in fixed arrays, no heap, built by
+//                constexpr constructor from edge array; same handles as
+//                Graph, so algorithms from KGAlg.hpp work unchanged
+//
+// make_static_graph -- deduces M from edge array
+//
+// SmallCovers -- minimum cover of every graph on K vertices, computed at
+//                compile time, indexed by edge mask
+//
+// Gadgets like Petersen are constexpr objects: their covers are constants
+// (see min_cover), copy on stack gives mutable loads for runtime algorithms.
+// Compile-time loops stay within default constexpr limits of compilers
+// only for small N, see asserts.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KSTATIC_GUARD__
+#define GRAPH_KSTATIC_GUARD__
+
+#include "KGraph.hpp"
+
+namespace KGR {
+
+template <int N, int M, typename VL = noload, typename EL = noload>
+class StaticGraph final {
+  static_assert(N > 0 && M >= 0, "Static graph needs vertices");
+
+  struct ARec {
+    uint32_t tip = 0;
+    EL load{};
+  };
+  uint32_t first_[N + 1] = {}; // last one is sentinel
+  ARec arcs_[2 * M + 1] = {};  // one spare keeps array nonempty
+  VL vloads_[N] = {};
+
+public:
+  // same as Graph: arc position and end of its vertex arcs
+  struct ArcPos {
+    uint32_t pos, end;
+    friend constexpr bool operator==(ArcPos lhs, ArcPos rhs) {
+      return lhs.pos == rhs.pos;
+    }
+  };
+
+  // storage interface for handles
+public:
+  using VLoad = VL;
+  using ELoad = EL;
+  constexpr VL &vload(uint32_t v) { return vloads_[v]; }
+  constexpr EL &eload(ArcPos a) { return arcs_[a.pos].load; }
+  constexpr ArcPos first_arc(uint32_t v) {
+    uint32_t fst = first_[v], lst = first_[v + 1];
+    return (fst == lst) ? nil_arc() : ArcPos{fst, lst};
+  }
+  constexpr ArcPos next_arc(ArcPos a) {
+    return (a.pos + 1 == a.end) ? nil_arc() : ArcPos{a.pos + 1, a.end};
+  }
+  constexpr uint32_t arc_tip(ArcPos a) { return arcs_[a.pos].tip; }
+  static constexpr ArcPos nil_arc() { return {nil_index, nil_index}; }
+
+public:
+  // N isolated vertices
+  constexpr StaticGraph() {}
+
+  // every edge becomes two arcs, arc order same as Graph(n, edges)
+  constexpr explicit StaticGraph(const int (&edges)[M][2]) {
+    for (int i = 0; i != M; ++i) {
+      assert(edges[i][0] >= 0 && edges[i][0] < N);
+      assert(edges[i][1] >= 0 && edges[i][1] < N);
+      first_[edges[i][0]] += 1;
+      first_[edges[i][1]] += 1;
+    }
+    // prefix sums give ends of ranges, backward fill moves them to starts
+    uint32_t sum = 0;
+    for (int v = 0; v <= N; ++v) {
+      sum += first_[v];
+      first_[v] = sum;
+    }
+    for (int i = M; i-- != 0;) {
+      arcs_[--first_[edges[i][0]]].tip = edges[i][1];
+      arcs_[--first_[edges[i][1]]].tip = edges[i][0];
+    }
+  }
+
+  // general interface
+public:
+  using VertexDescriptor = VertexHandle<StaticGraph>;
+  using EdgeDescriptor = EdgeHandle<StaticGraph>;
+  using VertexIterator = IndexIterator<StaticGraph>;
+  const char *name() const { return "G"; }
+  constexpr int nvertices() const { return N; }
+  constexpr int narcs() const { return first_[N]; }
+  VertexDescriptor front() { return vertex(0); }
+  VertexDescriptor back() { return vertex(N - 1); }
+  VertexIterator begin() { return VertexIterator(this, 0); }
+  VertexIterator end() { return VertexIterator(this, N); }
+  VertexDescriptor last_vertex() { return VertexDescriptor(); }
+  EdgeDescriptor last_edge() { return EdgeDescriptor(this, nil_arc()); }
+  int index(VertexDescriptor vd) { return vd.index(); }
+  VertexDescriptor vertex(int i) {
+    assert(i >= 0 && i < N);
+    return VertexDescriptor(this, i);
+  }
+  EdgeDescriptor get_edge(VertexDescriptor u, VertexDescriptor v) {
+    assert(u != last_vertex() && v != last_vertex());
+    uint32_t lst = first_[u.index() + 1];
+    for (uint32_t a = first_[u.index()]; a != lst; ++a)
+      if (arcs_[a].tip == v.index())
+        return EdgeDescriptor(this, ArcPos{a, lst});
+    return last_edge();
+  }
+  EdgeDescriptor get_sibling(EdgeDescriptor e, VertexDescriptor u) {
+    assert(e != last_edge() && u != last_vertex());
+    return get_edge(e->tip, u);
+  }
+  int degree(VertexDescriptor u) {
+    return first_[u.index() + 1] - first_[u.index()];
+  }
+
+  // compile-time queries, vertex sets are bit masks
+public:
+  constexpr uint64_t neighbors(int v) const {
+    static_assert(N <= 64, "Vertex set does not fit mask");
+    uint64_t mask = 0;
+    for (uint32_t a = first_[v]; a != first_[v + 1]; ++a)
+      mask |= uint64_t(1) << arcs_[a].tip;
+    return mask;
+  }
+
+  // every vertex out of s has all neighbors in s
+  constexpr bool is_cover(uint64_t s) const {
+    for (int v = 0; v != N; ++v)
+      if (!((s >> v) & 1) && (neighbors(v) & ~s) != 0)
+        return false;
+    return true;
+  }
+
+  // all 2^N subsets, smallest mask among minimum ones
+  constexpr uint64_t min_cover() const {
+    static_assert(N <= 16, "Too many subsets for compile time");
+    uint64_t best = (uint64_t(1) << N) - 1;
+    for (uint64_t s = 0; s != (uint64_t(1) << N); ++s)
+      if (__builtin_popcountll(s) < __builtin_popcountll(best) && is_cover(s))
+        best = s;
+    return best;
+  }
+
+  constexpr int min_cover_size() const {
+    return __builtin_popcountll(min_cover());
+  }
+
+  friend ostream &operator<<(ostream &stream, StaticGraph &g) {
+    out_dot_to_stream(stream, g);
+    return stream;
+  }
+};
+
+// constexpr auto g = make_static_graph<10>(edges), edges is int[M][2]
+template <int N, typename VL = noload, typename EL = noload, int M>
+constexpr StaticGraph<N, M, VL, EL>
+make_static_graph(const int (&edges)[M][2]) {
+  return StaticGraph<N, M, VL, EL>(edges);
+}
+
+// edge ij (i < j) is bit pair_bit(i, j), pairs ordered by j then i:
+// graph on first k vertices has mask below 2^(k(k-1)/2) for any k <= K,
+// so one table serves all smaller graphs
+template <int K> struct SmallCovers {
+  static_assert(K > 0 && K <= 5, "Table too large for compile time");
+  static constexpr int npairs = K * (K - 1) / 2;
+  static constexpr int pair_bit(int i, int j) { return j * (j - 1) / 2 + i; }
+
+  uint8_t cover[1 << npairs] = {}; // vertex mask of minimum cover
+
+  constexpr SmallCovers() {
+    for (uint32_t emask = 0; emask != (uint32_t(1) << npairs); ++emask) {
+      uint8_t best = (1 << K) - 1;
+      for (uint32_t s = 0; s != (uint32_t(1) << K); ++s)
+        if (__builtin_popcount(s) < __builtin_popcount(best) &&
+            covers(emask, s))
+          best = s;
+      cover[emask] = best;
+    }
+  }
+
+  static constexpr bool covers(uint32_t emask, uint32_t s) {
+    for (int j = 1; j != K; ++j)
+      for (int i = 0; i != j; ++i)
+        if (((emask >> pair_bit(i, j)) & 1) && !(((s >> i) | (s >> j)) & 1))
+          return false;
+    return true;
+  }
+};
+}
+
+#endif
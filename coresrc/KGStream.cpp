@@ -0,0 +1,101 @@
+//===-- KGStream.cpp -- semi-streaming vertex cover supplement ------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGStream.hpp"
+
+namespace KGR {
+
+void StreamCover::grow(unsigned v) {
+  if (v < mate_.size())
+    return;
+  mate_.resize(v + 1, -1);
+  degree_.resize(v + 1, 0);
+}
+
+void StreamCover::cleanup() {
+  mate_.clear();
+  degree_.clear();
+  pinned_.clear();
+  nedges_ = 0;
+  matching_ = 0;
+  pruned_ = false;
+}
+
+void StreamCover::add_edge(unsigned u, unsigned v) {
+  assert(u != v && "Loops are not supported");
+  assert(!pruned_ && "First pass is over");
+  grow(std::max(u, v));
+  degree_[u] += 1;
+  degree_[v] += 1;
+  nedges_ += 1;
+  if (mate_[u] == -1 && mate_[v] == -1) {
+    mate_[u] = v;
+    mate_[v] = u;
+    matching_ += 1;
+  }
+}
+
+size_t StreamCover::read(istream &stream) {
+  return for_each_edge(stream,
+                       [this](unsigned u, unsigned v) { add_edge(u, v); });
+}
+
+void StreamCover::start_prune() {
+  pinned_.assign(mate_.size(), 0);
+  pruned_ = true;
+}
+
+void StreamCover::prune_edge(unsigned u, unsigned v) {
+  assert(pruned_ && "start_prune shall be called first");
+  assert(u < mate_.size() && v < mate_.size() && "Edge not seen before");
+  if (mate_[u] == -1 || mate_[v] == -1) {
+    assert(mate_[u] != -1 || mate_[v] != -1);
+    pinned_[(mate_[u] == -1) ? v : u] = 1;
+    return;
+  }
+  if (pinned_[u] || pinned_[v])
+    return;
+  pinned_[(degree_[u] >= degree_[v]) ? u : v] = 1;
+}
+
+size_t StreamCover::prune(istream &stream) {
+  start_prune();
+  return for_each_edge(stream,
+                       [this](unsigned u, unsigned v) { prune_edge(u, v); });
+}
+
+int StreamCover::cover_size() const {
+  int cnt = 0;
+  for (int v = 0; v != nvertices(); ++v)
+    cnt += in_cover(v);
+  return cnt;
+}
+
+vector<int> StreamCover::cover() const {
+  vector<int> res;
+  for (int v = 0; v != nvertices(); ++v)
+    if (in_cover(v))
+      res.push_back(v);
+  return res;
+}
+
+bool stream_cover_file(const char *path, StreamCover &sc, bool prune) {
+  sc.cleanup();
+  ifstream ifs(path);
+  if (!ifs)
+    return false;
+  sc.read(ifs);
+  if (!prune)
+    return true;
+  ifs.clear();
+  ifs.seekg(0);
+  if (!ifs)
+    return false;
+  sc.prune(ifs);
+  return true;
+}
+}
@@ -0,0 +1,80 @@
+//===-- KGStream.hpp -- semi-streaming vertex cover -----------------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// StreamCover -- vertex cover of edge list that is never held in memory
+//
+// State is O(n) for n = max vertex id + 1: mate, degree and one flag per
+// vertex. Edges are consumed one at a time, from file or pipe.
+//
+// First pass keeps greedy maximal matching online: edge with both ends
+// free is matched. Matched vertices form a cover (unmatched edge would
+// have been matched) of size 2|M|, and any cover has at least |M| vertices,
+// so it is 2-approximation with lower bound at hand.
+//
+// Optional second pass over the same edges prunes this cover. Vertex is
+// pinned when it covers edge to outside of cover, or when it covers edge
+// inside of cover with no pinned end so far; of two such ends, one with
+// larger degree is pinned. Pinned vertices are still a cover, and matched
+// vertex with all neighbors in cover may be dropped.
+//
+// Input is edge list: line "u v" or "e u v" is edge, ids are used as they
+// are (1-based formats like PACE and DIMACS get unused vertex 0), all other
+// lines (comments, headers) are skipped.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KSTREAM_GUARD__
+#define GRAPH_KSTREAM_GUARD__
+
+#include "KGFormats.hpp"
+
+namespace KGR {
+
+class StreamCover final {
+  vector<int> mate_;        // -1 if free
+  vector<unsigned> degree_; // from first pass, with repeats
+  vector<char> pinned_;     // second pass result
+  size_t nedges_ = 0;
+  int matching_ = 0;
+  bool pruned_ = false;
+
+  void grow(unsigned v);
+
+public:
+  void cleanup();
+
+  // first pass, may be called for several parts of one edge list
+  void add_edge(unsigned u, unsigned v);
+  size_t read(istream &stream);
+
+  // second pass over all edges given to first pass, in any order
+  void prune_edge(unsigned u, unsigned v);
+  void start_prune();
+  size_t prune(istream &stream);
+
+  int nvertices() const { return mate_.size(); }
+  size_t nedges() const { return nedges_; }
+
+  // |M|, lower bound for minimum cover
+  int lower_bound() const { return matching_; }
+  int mate(int v) const { return mate_[v]; }
+
+  bool in_cover(int v) const {
+    return pruned_ ? pinned_[v] != 0 : mate_[v] != -1;
+  }
+  int cover_size() const;
+
+  // cover vertices, ascending
+  vector<int> cover() const;
+};
+
+// both passes over file, prune pass only if asked
+// false if file can not be opened
+bool stream_cover_file(const char *path, StreamCover &sc, bool prune = true);
+}
+
+#endif
@@ -0,0 +1,242 @@
+//===-- KGTreeDec.cpp -- vertex cover over tree decomposition supplement --===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "KGTreeDec.hpp"
+
+namespace KGR {
+
+int TreeDecomposition::width() const {
+  size_t w = 0;
+  for (auto &b : bags)
+    w = std::max(w, b.size());
+  return int(w) - 1;
+}
+
+bool tree_decomposition(const VCProblem &p, Elimination how,
+                        TreeDecomposition &td, int maxwidth) {
+  int n = p.n;
+  vector<set<int>> adj(n);
+  for (auto e : p.edges)
+    if (e.first != e.second) {
+      adj[e.first].insert(e.second);
+      adj[e.second].insert(e.first);
+    }
+
+  // vertices too wide to eliminate go last, their fill is not counted
+  const long long wide = std::numeric_limits<long long>::max() / 2;
+  auto score = [&](int v) -> long long {
+    long long deg = adj[v].size();
+    if (deg > maxwidth)
+      return wide + deg;
+    if (how == Elimination::min_degree)
+      return deg;
+    long long fill = 0;
+    for (auto a = adj[v].begin(); a != adj[v].end(); ++a)
+      for (auto b = std::next(a); b != adj[v].end(); ++b)
+        fill += (adj[*a].count(*b) == 0);
+    return fill;
+  };
+
+  set<pair<long long, int>> queue;
+  vector<long long> cur(n);
+  for (int v = 0; v != n; ++v) {
+    cur[v] = score(v);
+    queue.emplace(cur[v], v);
+  }
+
+  td.bags.assign(n, vector<int>());
+  td.parent.assign(n, -1);
+  td.order.clear();
+  vector<int> pos(n, -1);
+  vector<int> touched;
+  while (!queue.empty()) {
+    int v = queue.begin()->second;
+    queue.erase(queue.begin());
+    if ((int)adj[v].size() > maxwidth)
+      return false;
+    pos[v] = td.order.size();
+    td.order.push_back(v);
+    auto &bag = td.bags[v];
+    bag.push_back(v);
+    bag.insert(bag.end(), adj[v].begin(), adj[v].end());
+
+    // neighbors become clique, v leaves graph
+    touched.clear();
+    for (size_t i = 1; i != bag.size(); ++i) {
+      int a = bag[i];
+      adj[a].erase(v);
+      for (size_t j = 1; j != bag.size(); ++j)
+        if (i != j)
+          adj[a].insert(bag[j]);
+      touched.push_back(a);
+      if (how == Elimination::min_fill)
+        touched.insert(touched.end(), adj[a].begin(), adj[a].end());
+    }
+    adj[v].clear();
+
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (auto u : touched) {
+      if (pos[u] != -1)
+        continue;
+      queue.erase(make_pair(cur[u], u));
+      cur[u] = score(u);
+      queue.emplace(cur[u], u);
+    }
+  }
+
+  // parent is later neighbor eliminated first
+  for (int v = 0; v != n; ++v)
+    for (size_t i = 1; i != td.bags[v].size(); ++i) {
+      int u = td.bags[v][i];
+      if (td.parent[v] == -1 || pos[u] < pos[td.parent[v]])
+        td.parent[v] = u;
+    }
+  return true;
+}
+
+// child subset to parent positions, built by lowest bit
+static void project(const vector<uint32_t> &pmap, vector<uint32_t> &proj) {
+  proj.assign(size_t(1) << pmap.size(), 0);
+  for (size_t s = 1; s != proj.size(); ++s)
+    proj[s] = proj[s & (s - 1)] | pmap[__builtin_ctzll(s)];
+}
+
+void treedec_solve(const VCProblem &p, const TreeDecomposition &td,
+                   VCSolution &res) {
+  const int inf = 1 << 28;
+  int n = p.n;
+  assert((int)td.bags.size() == n && (int)td.order.size() == n);
+  vector<vector<int>> adj(n);
+  for (auto e : p.edges) {
+    adj[e.first].push_back(e.second);
+    adj[e.second].push_back(e.first);
+  }
+
+  // table[t][S] is min cover of subtree with S = cover inside bag t
+  // acc[t][S] is sum of forgotten children, indexed by subsets of t
+  vector<vector<int>> table(n), acc(n);
+  vector<int> where(n, -1);
+  vector<uint32_t> nbmask, pmap, proj;
+  vector<int> best;
+
+  auto place = [&where](const vector<int> &bag, bool on) {
+    for (size_t i = 0; i != bag.size(); ++i)
+      where[bag[i]] = on ? i : -1;
+  };
+
+  // parent positions of child bag vertices, 0 if forgotten
+  auto parent_map = [&](int t) {
+    auto &pbag = td.bags[td.parent[t]];
+    place(pbag, true);
+    pmap.clear();
+    for (auto v : td.bags[t])
+      pmap.push_back((where[v] == -1) ? 0 : uint32_t(1) << where[v]);
+    place(pbag, false);
+    project(pmap, proj);
+  };
+
+  for (auto t : td.order) {
+    auto &bag = td.bags[t];
+    int k = bag.size();
+    assert(k < 31 && "Bag too wide for table");
+
+    // introduce: S must cover edges inside bag
+    place(bag, true);
+    nbmask.assign(k, 0);
+    for (int i = 0; i != k; ++i)
+      for (auto u : adj[bag[i]])
+        if (where[u] != -1)
+          nbmask[i] |= uint32_t(1) << where[u];
+    place(bag, false);
+
+    auto &f = table[t];
+    f.assign(size_t(1) << k, inf);
+    for (uint32_t s = 0; s != f.size(); ++s) {
+      bool valid = true;
+      for (int i = 0; i != k && valid; ++i)
+        valid = ((s >> i) & 1) || (nbmask[i] & ~s) == 0;
+      if (valid)
+        f[s] = std::min(inf, __builtin_popcount(s) +
+                                 (acc[t].empty() ? 0 : acc[t][s]));
+    }
+    acc[t] = vector<int>();
+
+    int pt = td.parent[t];
+    if (pt == -1)
+      continue;
+
+    // forget: minimize over child vertices not in parent, shared ones are
+    // counted by parent
+    parent_map(t);
+    uint32_t imask = 0;
+    for (auto m : pmap)
+      imask |= m;
+    best.assign(size_t(1) << td.bags[pt].size(), inf);
+    for (uint32_t s = 0; s != f.size(); ++s)
+      if (f[s] < inf) {
+        int val = f[s] - __builtin_popcount(proj[s]);
+        best[proj[s]] = std::min(best[proj[s]], val);
+      }
+
+    // join: sum into parent
+    auto &pa = acc[pt];
+    if (pa.empty())
+      pa.assign(best.size(), 0);
+    for (uint32_t s = 0; s != pa.size(); ++s)
+      pa[s] = std::min(inf, pa[s] + best[s & imask]);
+  }
+
+  // top-down: root takes best subset, child best one agreeing with parent
+  vector<uint32_t> state(n, 0);
+  vector<char> incover(n, 0);
+  res = VCSolution();
+  for (auto it = td.order.rbegin(); it != td.order.rend(); ++it) {
+    int t = *it, pt = td.parent[t];
+    auto &f = table[t];
+    uint32_t pick = 0;
+    if (pt == -1) {
+      for (uint32_t s = 0; s != f.size(); ++s)
+        if (f[s] < f[pick])
+          pick = s;
+      res.size += f[pick];
+    } else {
+      parent_map(t);
+      uint32_t imask = 0;
+      for (auto m : pmap)
+        imask |= m;
+      uint32_t want = state[pt] & imask;
+      bool found = false;
+      for (uint32_t s = 0; s != f.size(); ++s)
+        if (proj[s] == want && (!found || f[s] < f[pick])) {
+          pick = s;
+          found = true;
+        }
+      assert(found && f[pick] < inf);
+    }
+    state[t] = pick;
+    for (size_t i = 0; i != td.bags[t].size(); ++i)
+      if ((pick >> i) & 1)
+        incover[td.bags[t][i]] = 1;
+    table[t] = vector<int>();
+  }
+
+  for (int v = 0; v != n; ++v)
+    if (incover[v])
+      res.cover.push_back(v);
+  assert(res.size == (int)res.cover.size());
+}
+
+bool vc_treedec(const VCProblem &p, VCSolution &res, int maxwidth,
+                Elimination how) {
+  TreeDecomposition td;
+  if (!tree_decomposition(p, how, td, maxwidth))
+    return false;
+  treedec_solve(p, td, res);
+  return true;
+}
+}
@@ -0,0 +1,56 @@
+//===-- KGTreeDec.hpp -- vertex cover over tree decomposition -------------===//
+//
+// This file is distributed under the GNU GPL v3 License.
+// See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains:
+//
+// TreeDecomposition -- bags and parent links, one bag per vertex
+//
+// tree_decomposition -- greedy elimination order to decomposition:
+//   min_degree -- next vertex has fewest neighbors
+//   min_fill   -- next vertex adds fewest fill edges to its neighborhood
+//
+// treedec_solve -- exact minimum cover by dynamic program over bags,
+//                  O(2^tw * tw * n), independent of cover size
+//
+// Program is the one over nice decompositions, with chains collapsed:
+// table of bag is min cover size per subset S of bag, S covers bag edges
+// (introduce), child table is minimized over its vertices not in parent
+// (forget) and summed into parent (join).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GRAPH_KTREEDEC_GUARD__
+#define GRAPH_KTREEDEC_GUARD__
+
+#include "KGSolver.hpp"
+
+namespace KGR {
+
+enum class Elimination { min_degree, min_fill };
+
+struct TreeDecomposition {
+  vector<vector<int>> bags; // bag of vertex v is v and its later neighbors
+  vector<int> parent;       // bag index or -1 for root
+  vector<int> order;        // elimination order, children before parents
+  int width() const;        // max bag size minus one, -1 if empty
+};
+
+// false if some bag exceeds maxwidth + 1, then td is incomplete
+bool tree_decomposition(const VCProblem &p, Elimination how,
+                        TreeDecomposition &td,
+                        int maxwidth = std::numeric_limits<int>::max());
+
+// td shall be decomposition of p, tables take 2^(bag size) ints per bag
+void treedec_solve(const VCProblem &p, const TreeDecomposition &td,
+                   VCSolution &res);
+
+// both steps, false (res untouched) if width exceeds maxwidth
+bool vc_treedec(const VCProblem &p, VCSolution &res, int maxwidth = 16,
+                Elimination how = Elimination::min_fill);
+}
+
+#endif
@@ -21,4 +21,123 @@ const char *recode(int color) {
     return "green";
   }
 }
+
+// first index of slice t when items are split evenly by weight, starts
+// are ascending prefix sums with total at back
+static int weight_slice(const vector<uint32_t> &starts, int t, int nthreads) {
+  int n = starts.size() - 1;
+  if (t == nthreads)
+    return n;
+  uint64_t target = uint64_t(starts[n]) * t / nthreads;
+  return std::lower_bound(starts.begin(), starts.begin() + n, target) -
+         starts.begin();
+}
+
+// typical rows are short, insertion sort beats std::sort there
+static void sort_row(uint32_t *first, uint32_t *last) {
+  if (last - first > 32) {
+    std::sort(first, last);
+    return;
+  }
+  for (uint32_t *it = first; it != last; ++it) {
+    uint32_t x = *it, *pos = it;
+    for (; pos != first && pos[-1] > x; --pos)
+      *pos = pos[-1];
+    *pos = x;
+  }
+}
+
+// radix digit is high part of source vertex, so every thread owns block of
+// counters and writes its own ranges, no atomics: locked increments on
+// random lines serialize cache misses
+void bulk_csr(int n, const pair<int, int> *edges, size_t m, int nthreads,
+              vector<uint32_t> &offsets, vector<uint32_t> &targets) {
+  nthreads = thread_count(nthreads);
+  assert(2 * m < nil_index && "Too many arcs for 32-bit offsets");
+  int shift = 0;
+  while ((n >> shift) >= (1 << 12))
+    shift += 1;
+  int nb = (n >> shift) + 1;
+
+  // arcs per thread and bucket
+  vector<uint32_t> hist((size_t)nthreads * nb, 0);
+  run_threads(nthreads, [&](int t) {
+    uint32_t *h = hist.data() + (size_t)t * nb;
+    size_t lo = m * t / nthreads, hi = m * (t + 1) / nthreads;
+    for (size_t i = lo; i != hi; ++i) {
+      int u = edges[i].first, v = edges[i].second;
+      assert(u >= 0 && u < n && v >= 0 && v < n);
+      assert(u != v && "Loops are not supported");
+      h[u >> shift] += 1;
+      h[v >> shift] += 1;
+    }
+  });
+
+  // bucket-major prefix sums, hist becomes write position of thread
+  vector<uint32_t> bstart(nb + 1, 0);
+  uint32_t sum = 0;
+  for (int b = 0; b != nb; ++b) {
+    bstart[b] = sum;
+    for (int t = 0; t != nthreads; ++t) {
+      uint32_t cnt = hist[(size_t)t * nb + b];
+      hist[(size_t)t * nb + b] = sum;
+      sum += cnt;
+    }
+  }
+  bstart[nb] = sum;
+
+  vector<uint64_t> keys(sum);
+  run_threads(nthreads, [&](int t) {
+    uint32_t *h = hist.data() + (size_t)t * nb;
+    size_t lo = m * t / nthreads, hi = m * (t + 1) / nthreads;
+    for (size_t i = lo; i != hi; ++i) {
+      uint32_t u = edges[i].first, v = edges[i].second;
+      keys[h[u >> shift]++] = (uint64_t(u) << 32) | v;
+      keys[h[v >> shift]++] = (uint64_t(v) << 32) | u;
+    }
+  });
+
+  // inside bucket: counting sort by source, then rows sorted and merged
+  // raw[v] is start of row v in arcs, deg[v] is its merged length
+  vector<uint32_t> arcs(sum), raw(n + 1), deg(n);
+  raw[n] = sum;
+  run_threads(nthreads, [&](int t) {
+    vector<uint32_t> fill;
+    int bhi = weight_slice(bstart, t + 1, nthreads);
+    for (int b = weight_slice(bstart, t, nthreads); b != bhi; ++b) {
+      int vlo = b << shift, vhi = std::min(n, (b + 1) << shift);
+      if (vlo >= vhi)
+        continue;
+      fill.assign(vhi - vlo + 1, 0);
+      for (uint32_t k = bstart[b]; k != bstart[b + 1]; ++k)
+        fill[(keys[k] >> 32) - vlo + 1] += 1;
+      fill[0] = bstart[b];
+      for (int v = vlo; v != vhi; ++v) {
+        fill[v - vlo + 1] += fill[v - vlo];
+        raw[v] = fill[v - vlo];
+      }
+      for (uint32_t k = bstart[b]; k != bstart[b + 1]; ++k)
+        arcs[fill[(keys[k] >> 32) - vlo]++] = uint32_t(keys[k]);
+      for (int v = vlo; v != vhi; ++v) {
+        uint32_t *first = arcs.data() + raw[v];
+        uint32_t *last =
+            arcs.data() + ((v + 1 == vhi) ? bstart[b + 1] : raw[v + 1]);
+        sort_row(first, last);
+        deg[v] = std::unique(first, last) - first;
+      }
+    }
+  });
+  keys = vector<uint64_t>();
+
+  offsets.assign(n + 1, 0);
+  for (int v = 0; v != n; ++v)
+    offsets[v + 1] = offsets[v] + deg[v];
+  targets.resize(offsets[n]);
+  run_threads(nthreads, [&](int t) {
+    int vhi = weight_slice(raw, t + 1, nthreads);
+    for (int v = weight_slice(raw, t, nthreads); v != vhi; ++v)
+      std::copy(arcs.begin() + raw[v], arcs.begin() + raw[v] + deg[v],
+                targets.begin() + offsets[v]);
+  });
+}
 }
@@ -5,7 +5,7 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// Graph may be mutable or immutable (TODO: memory-efficient immutable graph)
+// Graph may be mutable (GraphBuilder, pointers) or immutable (Graph, indices)
 // Vertices and edges might have some load (like color, weight, etc) or not
 // TODO: specialization for noload without load at all
 //
@@ -29,6 +29,7 @@ namespace KGR {
 
 struct noload {
   friend ostream &operator<<(ostream &stream, const noload &) { return stream; }
+  friend void out_load(BufWriter &, const noload &) {}
 };
 
 const char *recode(int color);
@@ -39,10 +40,166 @@ struct colorload {
     stream << "color=\"" << recode(l.color) << "\"";
     return stream;
   }
+  friend void out_load(BufWriter &w, const colorload &l) {
+    w.put("color=\"");
+    w.put(recode(l.color));
+    w.put('"');
+  }
 };
 
-// TODO: think about immutable graph
-// idea is: fixed vertex array, fixed edge array, everything on stack, etc.
+// Immutable graphs: Graph below (indices, heap arrays), SplitGraph in
+// KGSplit.hpp (Graph with loads in arrays apart from topology) and
+// StaticGraph in KGStatic.hpp (fixed vertex array, fixed edge array,
+// everything on stack)
+
+//------------------------------------------------------------------------------
+//
+//  Index handles
+//
+//------------------------------------------------------------------------------
+
+// Graphs with contiguous storage keep 32-bit indices instead of pointers.
+// Handles below give them same descriptor syntax as pointer-based graphs:
+//   vd->load, vd->arcs, ed->tip, ed->next, ed->load
+// so algorithms in KGAlg.hpp work on both.
+//
+// Graph G with contiguous storage shall provide:
+//   VLoad, ELoad, ArcPos (ArcPos comparable with ==)
+//   VLoad &vload(uint32_t v)
+//   ELoad &eload(ArcPos a)
+//   ArcPos first_arc(uint32_t v) -- nil_arc() for isolated vertex
+//   ArcPos next_arc(ArcPos a)    -- nil_arc() after last arc
+//   uint32_t arc_tip(ArcPos a)
+//   static ArcPos nil_arc()
+//
+// Handle carries graph pointer to make -> work, but only index is stored
+// in graph itself.
+
+constexpr uint32_t nil_index = std::numeric_limits<uint32_t>::max();
+
+template <typename G> struct VertexRef;
+template <typename G> struct EdgeRef;
+
+template <typename G> class VertexHandle final {
+  G *g_ = nullptr;
+  uint32_t idx_ = nil_index;
+
+public:
+  VertexHandle() = default;
+  VertexHandle(G *g, uint32_t idx) : g_(g), idx_(idx) {}
+  uint32_t index() const { return idx_; }
+  VertexRef<G> operator->() const;
+
+  friend bool operator==(VertexHandle lhs, VertexHandle rhs) {
+    return lhs.idx_ == rhs.idx_;
+  }
+  friend bool operator!=(VertexHandle lhs, VertexHandle rhs) {
+    return lhs.idx_ != rhs.idx_;
+  }
+  friend bool operator<(VertexHandle lhs, VertexHandle rhs) {
+    return lhs.idx_ < rhs.idx_;
+  }
+};
+
+template <typename G> class EdgeHandle final {
+  using ArcPos = typename G::ArcPos;
+  G *g_ = nullptr;
+  ArcPos pos_ = G::nil_arc();
+
+public:
+  EdgeHandle() = default;
+  EdgeHandle(G *g, ArcPos pos) : g_(g), pos_(pos) {}
+  ArcPos pos() const { return pos_; }
+  EdgeRef<G> operator->() const;
+  explicit operator bool() const { return !(pos_ == G::nil_arc()); }
+
+  friend bool operator==(EdgeHandle lhs, EdgeHandle rhs) {
+    return lhs.pos_ == rhs.pos_;
+  }
+  friend bool operator!=(EdgeHandle lhs, EdgeHandle rhs) {
+    return !(lhs.pos_ == rhs.pos_);
+  }
+};
+
+// temporaries returned by operator->, they live until end of expression
+// but loads are references into graph storage
+template <typename G> struct VertexRef {
+  typename G::VLoad &load;
+  EdgeHandle<G> arcs;
+  const VertexRef *operator->() const { return this; }
+};
+
+template <typename G> struct EdgeRef {
+  typename G::ELoad &load;
+  VertexHandle<G> tip;
+  EdgeHandle<G> next;
+  const EdgeRef *operator->() const { return this; }
+};
+
+template <typename G> VertexRef<G> VertexHandle<G>::operator->() const {
+  assert(g_ && idx_ != nil_index && "Dereferencing nil vertex is bad idea");
+  return {g_->vload(idx_), EdgeHandle<G>(g_, g_->first_arc(idx_))};
+}
+
+template <typename G> EdgeRef<G> EdgeHandle<G>::operator->() const {
+  assert(g_ && *this && "Dereferencing nil edge is bad idea");
+  return {g_->eload(pos_), VertexHandle<G>(g_, g_->arc_tip(pos_)),
+          EdgeHandle<G>(g_, g_->next_arc(pos_))};
+}
+
+// iterates vertices 0 .. n-1 as handles
+template <typename G> class IndexIterator final {
+  G *g_;
+  uint32_t idx_;
+
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = VertexHandle<G>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = VertexHandle<G>;
+
+  IndexIterator(G *g, uint32_t idx) : g_(g), idx_(idx) {}
+  VertexHandle<G> operator*() const { return VertexHandle<G>(g_, idx_); }
+  IndexIterator &operator++() {
+    ++idx_;
+    return *this;
+  }
+  IndexIterator operator++(int) {
+    IndexIterator tmp = *this;
+    ++idx_;
+    return tmp;
+  }
+  friend bool operator==(IndexIterator lhs, IndexIterator rhs) {
+    return lhs.idx_ == rhs.idx_;
+  }
+  friend bool operator!=(IndexIterator lhs, IndexIterator rhs) {
+    return lhs.idx_ != rhs.idx_;
+  }
+};
+
+//------------------------------------------------------------------------------
+//
+//  Bulk construction
+//
+//------------------------------------------------------------------------------
+
+// calls f(t) for t = 0 .. nthreads - 1 in parallel, t = 0 in caller thread
+template <typename F> void run_threads(int nthreads, F f) {
+  vector<std::thread> threads;
+  for (int t = 1; t < nthreads; ++t)
+    threads.emplace_back(f, t);
+  f(0);
+  for (auto &t : threads)
+    t.join();
+}
+
+// undirected edge list to CSR, every edge becomes two arcs, rows sorted
+// and parallel edges merged: radix pass on high bits of source (per-thread
+// counts, prefix sums, scatter), counting sort inside each bucket, then
+// rows are sorted independently; all passes are split between nthreads
+void bulk_csr(int n, const pair<int, int> *edges, size_t m, int nthreads,
+              vector<uint32_t> &offsets, vector<uint32_t> &targets);
 
 //------------------------------------------------------------------------------
 //
@@ -79,6 +236,19 @@ static inline void add_link_to(VT *v1, VT *v2, EL l) {
   v1->link_to(v2, e12);
 }
 
+// removes first arc from v1 to v2, false if there is none
+template <typename VT> static inline bool remove_link_to(VT *v1, VT *v2) {
+  for (auto pe = &v1->arcs; *pe != nullptr; pe = &(*pe)->next)
+    if ((*pe)->tip == v2) {
+      auto e = *pe;
+      *pe = e->next;
+      v1->unlinked(e);
+      delete e;
+      return true;
+    }
+  return false;
+}
+
 template <typename VT, typename EL>
 static inline void link(VT *v1, VT *v2, EL l) {
   assert(v1 && v2 && "Linking to null vertex is bad idea");
@@ -94,15 +264,67 @@ template <typename VL, typename EL> class GraphBuilder final {
   // vertex for this graph
   struct Vertex : public IVertex<VL, Edge<EL, Vertex>> {
     using ET = Edge<EL, Vertex>;
+    uint32_t id = 0;  // position in vertices_, maintained by builder
+    uint32_t deg = 0; // number of arcs
+
+    // tip to its first arc, only for hubs when index is on
+    std::unique_ptr<unordered_map<Vertex *, ET *>> hub;
+
     void link_to(Vertex *v, ET *edge) {
       assert(edge->tip == v);
       // without this-> we have unqualified lookup!
       edge->next = this->arcs;
       this->arcs = edge;
+      deg += 1;
+      if (hub)
+        (*hub)[v] = edge;
+    }
+
+    // edge is already out of list, its next is still valid
+    // if it was indexed, next parallel arc takes its place
+    void unlinked(ET *edge) {
+      deg -= 1;
+      if (!hub)
+        return;
+      auto it = hub->find(edge->tip);
+      if (it == hub->end() || it->second != edge)
+        return;
+      for (auto e = edge->next; e != nullptr; e = e->next)
+        if (e->tip == edge->tip) {
+          it->second = e;
+          return;
+        }
+      hub->erase(it);
     }
   };
   vector<Vertex *> vertices_;
 
+  // 0 if there is no adjacency index, see set_hub_degree
+  int hub_degree_ = 0;
+
+  void check_hub(Vertex *u) {
+    if (hub_degree_ == 0 || u->hub || (int)u->deg < hub_degree_)
+      return;
+    u->hub.reset(new unordered_map<Vertex *, typename Vertex::ET *>);
+    u->hub->reserve(2 * u->deg);
+    // emplace keeps first arc of parallel ones
+    for (auto e = u->arcs; e != nullptr; e = e->next)
+      u->hub->emplace(e->tip, e);
+  }
+
+  void reindex() {
+    for (auto v : vertices_) {
+      v->hub.reset();
+      check_hub(v);
+    }
+  }
+
+  template <typename L> void make_link(Vertex *u, Vertex *v, L l) {
+    link(u, v, l);
+    check_hub(u);
+    check_hub(v);
+  }
+
 public:
   GraphBuilder() = default;
   GraphBuilder(const GraphBuilder &) = delete;
@@ -124,8 +346,18 @@ public:
   VertexIterator end() { return vertices_.end(); }
   VertexDescriptor last_vertex() { return nullptr; }
   EdgeDescriptor last_edge() { return nullptr; }
+  int index(VT *u) {
+    assert(u && vertices_[u->id] == u);
+    return u->id;
+  }
+  VT *vertex(int i) { return vertices_[i]; }
+  // O(1) expected for indexed hubs, below hub degree scan is short
   ET *get_edge(VT *u, VT *v) {
     assert(u && v && "Edge for null is bad idea");
+    if (u->hub) {
+      auto it = u->hub->find(v);
+      return (it == u->hub->end()) ? nullptr : it->second;
+    }
     for (auto eu = u->arcs; eu != nullptr; eu = eu->next)
       if (eu->tip == v)
         return eu;
@@ -134,35 +366,63 @@ public:
   ET *get_sibling(ET *e, VT *u) {
     assert(e->tip != u);
     assert(e && u && "Sibling for null is bad idea too");
-    // TODO: 2-blocks for edges will make this O(1) instead O(n)
-    //       like: return ((e % 4) == 0) ? (e + 4) : (e - 4)
-    //       but this effectiveness cost some uglyness and protability
-    for (auto ev = e->tip->arcs; ev != nullptr; ev = ev->next)
-      if (ev->tip == u)
-        return ev;
-    return nullptr;
+    return get_edge(e->tip, u);
   }
   int degree(VT *u) {
     assert(u != nullptr);
-    int deg = 0;
-    for (auto eu = u->arcs; eu != nullptr; eu = eu->next)
-      deg += 1;
-    return deg;
+    return u->deg;
   }
 
   // modifiable specifics
 public:
   int add_default_vertex(void) {
     VT *vert = new Vertex();
+    vert->id = vertices_.size();
     vertices_.push_back(vert);
     return vertices_.size() - 1;
   }
 
-  // link with default load
-  void add_link(int i, int j) {
+  // adjacency index: vertices of degree at least hub_degree keep hash
+  // of tips, so get_edge is O(1) expected for them and O(hub_degree) for
+  // others; add_link then rejects existing links; 0 drops index
+  void set_hub_degree(int hub_degree) {
+    assert(hub_degree >= 0);
+    hub_degree_ = hub_degree;
+    reindex();
+  }
+
+  // link with default load, false if index is on and link exists
+  bool add_link(int i, int j) {
+    assert(i >= 0 && i < (int)vertices_.size());
+    assert(j >= 0 && j < (int)vertices_.size());
+    if (hub_degree_ != 0 && get_edge(vertices_[i], vertices_[j]))
+      return false;
+    make_link(vertices_[i], vertices_[j], EL{});
+    return true;
+  }
+
+  // many links at once, parallel edges (within array) merged
+  // sorting and merging is bulk_csr with nthreads, then links are made
+  // in ascending order of ends; with index existing links are skipped
+  void add_edges_bulk(const pair<int, int> *edges, size_t m,
+                      int nthreads = 1) {
+    vector<uint32_t> offsets, targets;
+    bulk_csr(vertices_.size(), edges, m, nthreads, offsets, targets);
+    for (size_t u = 0; u + 1 < offsets.size(); ++u)
+      for (uint32_t a = offsets[u]; a != offsets[u + 1]; ++a)
+        if (u < targets[a])
+          add_link(u, targets[a]);
+  }
+
+  // removes one i-j link, false if there was none
+  bool remove_link(int i, int j) {
     assert(i >= 0 && i < (int)vertices_.size());
     assert(j >= 0 && j < (int)vertices_.size());
-    link(vertices_[i], vertices_[j], EL{});
+    if (!remove_link_to(vertices_[i], vertices_[j]))
+      return false;
+    bool back = remove_link_to(vertices_[j], vertices_[i]);
+    assert(back && "Links are always symmetric");
+    return true;
   }
 
   void partial_cleanup(int nstart, int nend) {
@@ -181,6 +441,8 @@ public:
       delete vertices_[vi];
     }
     vertices_.erase(vertices_.begin() + nstart, vertices_.begin() + nend);
+    for (auto vi = nstart; vi != (int)vertices_.size(); ++vi)
+      vertices_[vi]->id = vi;
   }
 
   void cleanup() {
@@ -207,7 +469,7 @@ public:
       int inext = add_default_vertex();
       VT *vnext = vertices_[inext];
       if (vcurr)
-        link(vcurr, vnext, EL{});
+        make_link(vcurr, vnext, EL{});
       vcurr = vnext;
     }
   }
@@ -242,19 +504,17 @@ public:
     int start = vertices_.size();
     assert(start > 0 && "Not good idea doing this on empty graph");
     add_isolated(start);
-    int n = 0;
-    map<VertexDescriptor, int> indexes;
-    for (auto vd : vertices_)
-      indexes[vd] = n++;
 
     for (int i = 0; i != start; ++i)
       for (auto ed = vertices_[i]->arcs; ed != nullptr; ed = ed->next) {
-        int nold = indexes[ed->tip];
+        int nold = ed->tip->id;
         int nnew = nold + start;
         ed->tip = vertices_[nnew];
         add_link_to(vertices_[nnew], vertices_[i], EL{});
       }
 
+    // tips changed, hubs are keyed by tips
+    reindex();
     for (int i = 0; i != start; ++i)
       colors_callback(vertices_[i]);
   }
@@ -262,17 +522,12 @@ public:
   // brings {0,1}-colored bipartite back to {0,1,2}-colored graph
   // color 1 is for 1/2 vertices of core task
   template <typename C> void join_from_bipart(C colors_callback) {
-    int n = 0;
-    map<VertexDescriptor, int> indexes;
-    for (auto vd : vertices_)
-      indexes[vd] = n++;
-
     int nall = vertices_.size();
     assert((nall % 2) == 0);
     int nhalf = nall / 2;
     for (int idx = 0; idx != nhalf; ++idx) {
       for (auto ed = vertices_[idx]->arcs; ed != nullptr; ed = ed->next) {
-        int tipold = indexes[ed->tip];
+        int tipold = ed->tip->id;
         assert(tipold > nhalf - 1);
         int tipnew = tipold - nhalf;
         ed->tip = vertices_[tipnew];
@@ -282,14 +537,257 @@ public:
 
     partial_cleanup(nhalf, nall);
     assert(vertices_.size() == nhalf);
+    reindex();
   }
 
   friend ostream &operator<<(ostream &stream, GraphBuilder &g) {
     out_dot_to_stream(stream, g);
     return stream;
   }
+};
 
-  // TODO: dump to immutable
+//------------------------------------------------------------------------------
+//
+//  Immutable graph
+//
+//------------------------------------------------------------------------------
+
+// Graph keeps row offsets, arc tips and loads in layout policy L:
+//   uint32_t &first(v)   -- offset of first arc of v, v up to n inclusive
+//   uint32_t &tip(a), VL &vload(v), EL &eload(a)
+//   clear(n), push_vertex(load), push_arc(tip, load), close() -- rows
+//                           appended in order, close() adds sentinel
+//   resize(n, narcs)     -- zero offsets and tips, default loads
+//   assign_csr(offsets, targets, nthreads) -- arrays of bulk_csr
+//   nvertices(), narcs()
+// InlineLoads below keeps load next to offset and tip; SplitLoads in
+// KGSplit.hpp keeps loads in own arrays. Build code is shared.
+
+// all vertices in one array, all arcs in another, indices instead of pointers
+// arcs of v are arcs_[vertices_[v].first .. vertices_[v + 1].first)
+// half-edge costs 4 bytes plus load instead of two pointers plus load
+template <typename VL, typename EL> class InlineLoads final {
+  struct VRec {
+    uint32_t first;
+    VL load;
+  };
+  struct ARec {
+    uint32_t tip;
+    EL load;
+  };
+  vector<VRec> vertices_; // n + 1 records, last one is sentinel
+  vector<ARec> arcs_;
+
+public:
+  InlineLoads() : vertices_(1, VRec{0, VL{}}) {}
+
+  uint32_t &first(uint32_t v) { return vertices_[v].first; }
+  uint32_t &tip(uint32_t a) { return arcs_[a].tip; }
+  VL &vload(uint32_t v) { return vertices_[v].load; }
+  EL &eload(uint32_t a) { return arcs_[a].load; }
+
+  void clear(size_t n) {
+    vertices_.clear();
+    arcs_.clear();
+    vertices_.reserve(n + 1);
+  }
+  void push_vertex(const VL &load) {
+    vertices_.push_back(VRec{(uint32_t)arcs_.size(), load});
+  }
+  void push_arc(uint32_t tip, const EL &load) {
+    arcs_.push_back(ARec{tip, load});
+  }
+  void close() { vertices_.push_back(VRec{(uint32_t)arcs_.size(), VL{}}); }
+
+  void resize(size_t n, size_t narcs) {
+    vertices_.assign(n + 1, VRec{0, VL{}});
+    arcs_.assign(narcs, ARec{0, EL{}});
+  }
+
+  // arcs are laid out in one allocation, records filled by nthreads
+  void assign_csr(vector<uint32_t> &offsets, vector<uint32_t> &targets,
+                  int nthreads) {
+    size_t n = offsets.size() - 1;
+    vertices_.resize(n + 1);
+    arcs_.resize(targets.size());
+    run_threads(nthreads, [&](int t) {
+      for (size_t v = t; v <= n; v += nthreads)
+        vertices_[v] = VRec{offsets[v], VL{}};
+      size_t lo = targets.size() * t / nthreads;
+      size_t hi = targets.size() * (t + 1) / nthreads;
+      for (size_t a = lo; a != hi; ++a)
+        arcs_[a] = ARec{targets[a], EL{}};
+    });
+  }
+
+  int nvertices() const { return vertices_.size() - 1; }
+  int narcs() const { return arcs_.size(); }
+};
+
+template <typename VL, typename EL, typename L = InlineLoads<VL, EL>>
+class Graph final {
+  L store_;
+  vector<uint32_t> orig_; // index before relabeling, empty if not relabeled
+
+public:
+  // arc position and end of its vertex arcs to find next in O(1)
+  struct ArcPos {
+    uint32_t pos, end;
+    friend bool operator==(ArcPos lhs, ArcPos rhs) {
+      return lhs.pos == rhs.pos;
+    }
+  };
+
+  // storage interface for handles
+public:
+  using VLoad = VL;
+  using ELoad = EL;
+  VL &vload(uint32_t v) { return store_.vload(v); }
+  EL &eload(ArcPos a) { return store_.eload(a.pos); }
+  ArcPos first_arc(uint32_t v) {
+    uint32_t fst = store_.first(v), lst = store_.first(v + 1);
+    return (fst == lst) ? nil_arc() : ArcPos{fst, lst};
+  }
+  ArcPos next_arc(ArcPos a) {
+    return (a.pos + 1 == a.end) ? nil_arc() : ArcPos{a.pos + 1, a.end};
+  }
+  uint32_t arc_tip(ArcPos a) { return store_.tip(a.pos); }
+  static ArcPos nil_arc() { return {nil_index, nil_index}; }
+
+public:
+  Graph() = default;
+
+  // freeze mutable graph: same vertex order, same arc order, same loads
+  explicit Graph(GraphBuilder<VL, EL> &src) { freeze(src, nullptr); }
+
+  // freeze with relabeling: vertex order[i] of src becomes vertex i
+  // see vertex_order in KGOrder.hpp, original(vd) maps results back
+  Graph(GraphBuilder<VL, EL> &src, const vector<int> &order)
+      : orig_(order.begin(), order.end()) {
+    assert((int)order.size() == src.nvertices());
+    freeze(src, &order);
+  }
+
+  // from edge list, every edge becomes two arcs
+  Graph(int n, const vector<pair<int, int>> &edges) {
+    store_.resize(n, 2 * edges.size());
+    fill_arcs(edges);
+  }
+
+  // bulk from edge array with nthreads, rows sorted and parallel edges
+  // merged
+  Graph(int n, const pair<int, int> *edges, size_t m, int nthreads) {
+    vector<uint32_t> offsets, targets;
+    nthreads = thread_count(nthreads);
+    bulk_csr(n, edges, m, nthreads, offsets, targets);
+    store_.assign_csr(offsets, targets, nthreads);
+  }
+
+  // from edge list with relabeling, like above
+  Graph(int n, const vector<pair<int, int>> &edges, const vector<int> &order)
+      : orig_(order.begin(), order.end()) {
+    assert((int)order.size() == n);
+    vector<pair<int, int>> relabeled(edges.size());
+    vector<int> pos(n);
+    for (int i = 0; i != n; ++i)
+      pos[order[i]] = i;
+    for (size_t i = 0; i != edges.size(); ++i)
+      relabeled[i] = make_pair(pos[edges[i].first], pos[edges[i].second]);
+    store_.resize(n, 2 * edges.size());
+    fill_arcs(relabeled);
+  }
+
+private:
+  // order is nullptr for same vertex order
+  void freeze(GraphBuilder<VL, EL> &src, const vector<int> *order) {
+    int n = src.nvertices();
+    vector<uint32_t> pos;
+    if (order) {
+      pos.resize(n);
+      for (int i = 0; i != n; ++i)
+        pos[(*order)[i]] = i;
+    }
+    store_.clear(n);
+    for (int i = 0; i != n; ++i) {
+      auto vd = src.vertex(order ? (*order)[i] : i);
+      store_.push_vertex(vd->load);
+      for (auto ed = vd->arcs; ed != src.last_edge(); ed = ed->next) {
+        uint32_t tip = src.index(ed->tip);
+        store_.push_arc(order ? pos[tip] : tip, ed->load);
+      }
+    }
+    store_.close();
+  }
+
+  void fill_arcs(const vector<pair<int, int>> &edges) {
+    int n = nvertices();
+    for (auto e : edges) {
+      assert(e.first >= 0 && e.first < n);
+      assert(e.second >= 0 && e.second < n);
+      store_.first(e.first) += 1;
+      store_.first(e.second) += 1;
+    }
+    // prefix sums give ends of ranges, backward fill moves them to starts
+    uint32_t sum = 0;
+    for (int v = 0; v <= n; ++v) {
+      sum += store_.first(v);
+      store_.first(v) = sum;
+    }
+    for (auto it = edges.rbegin(); it != edges.rend(); ++it) {
+      store_.tip(--store_.first(it->first)) = it->second;
+      store_.tip(--store_.first(it->second)) = it->first;
+    }
+  }
+
+  // general interface
+public:
+  using VertexDescriptor = VertexHandle<Graph>;
+  using EdgeDescriptor = EdgeHandle<Graph>;
+  using VertexIterator = IndexIterator<Graph>;
+  const char *name() const { return "G"; }
+  int nvertices() { return store_.nvertices(); }
+  int narcs() { return store_.narcs(); }
+  VertexDescriptor front() { return vertex(0); }
+  VertexDescriptor back() { return vertex(nvertices() - 1); }
+  VertexIterator begin() { return VertexIterator(this, 0); }
+  VertexIterator end() { return VertexIterator(this, nvertices()); }
+  VertexDescriptor last_vertex() { return VertexDescriptor(); }
+  EdgeDescriptor last_edge() { return EdgeDescriptor(this, nil_arc()); }
+  int index(VertexDescriptor vd) { return vd.index(); }
+  int original(VertexDescriptor vd) {
+    return orig_.empty() ? vd.index() : orig_[vd.index()];
+  }
+  VertexDescriptor vertex(int i) {
+    assert(i >= 0 && i < nvertices());
+    return VertexDescriptor(this, i);
+  }
+  EdgeDescriptor get_edge(VertexDescriptor u, VertexDescriptor v) {
+    assert(u != last_vertex() && v != last_vertex());
+    uint32_t lst = store_.first(u.index() + 1);
+    for (uint32_t a = store_.first(u.index()); a != lst; ++a)
+      if (store_.tip(a) == v.index())
+        return EdgeDescriptor(this, ArcPos{a, lst});
+    return last_edge();
+  }
+  EdgeDescriptor get_sibling(EdgeDescriptor e, VertexDescriptor u) {
+    assert(e != last_edge() && u != last_vertex());
+    return get_edge(e->tip, u);
+  }
+  int degree(VertexDescriptor u) {
+    return store_.first(u.index() + 1) - store_.first(u.index());
+  }
+
+  // arc number of edge handle, index into edge loads of split layout
+  uint32_t arc(EdgeDescriptor ed) const { return ed.pos().pos; }
+
+  // layout specific parts, like topology arrays of SplitLoads
+  L &layout() { return store_; }
+  const L &layout() const { return store_; }
+
+  friend ostream &operator<<(ostream &stream, Graph &g) {
+    out_dot_to_stream(stream, g);
+    return stream;
+  }
 };
 }
 